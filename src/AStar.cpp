@@ -1,12 +1,11 @@
 #include "AStar.hpp"
 
-#include "RobotWorld.hpp"
-#include "Shape2DUtils.hpp"
-#include "Wall.hpp"
+#include "GridConnectivity.hpp"
 
 #include <algorithm>
 #include <cmath>
 #include <iterator>
+#include <limits>
 #include <sstream>
 #include <stdexcept>
 #include <utility>
@@ -30,71 +29,64 @@ namespace PathAlgorithm
 		return std::sqrt( (aStart.x - aGoal.x) * (aStart.x - aGoal.x) + (aStart.y - aGoal.y) * (aStart.y - aGoal.y));
 	}
 	/**
-	 *
+	 * Walks back along the predecessors from aCurrentNode, without recursion
 	 */
-	Path ConstructPath(	VertexMap& aPredecessorMap,
-						const Vertex& aCurrentNode)
+	void ConstructPath(	const VertexMap& aPredecessorMap,
+						const Vertex& aCurrentNode,
+						Path& aPath)
 	{
-		VertexMap::iterator i = aPredecessorMap.find( aCurrentNode);
-		if (i != aPredecessorMap.end())
-		{
-			Path path = ConstructPath( aPredecessorMap, (*i).second);
-			path.push_back( aCurrentNode);
-			return path;
-		} else
+		aPath.clear();
+		aPath.push_back( aCurrentNode);
+		for (VertexMap::const_iterator i = aPredecessorMap.find( aCurrentNode); i != aPredecessorMap.end(); i = aPredecessorMap.find( (*i).second))
 		{
-			Path path;
-			path.push_back( aCurrentNode);
-			return path;
+			aPath.push_back( (*i).second);
 		}
+		std::reverse( aPath.begin(), aPath.end());
 	}
 	/**
-	 *
+	 * Costs that differ less than this are equal
 	 */
-	std::vector< Vertex > GetNeighbours(	const Vertex& aVertex,
-											int aFreeRadius /*= 1*/)
+	const double costTolerance = 1e-6;
+	/**
+	 * Replaces the contents of aConnections with the connections to the free 8-connected neighbours of aVertex
+	 */
+	void GetNeighbourConnections(	const Vertex& aVertex,
+									const OccupancyGrid& anOccupancyGrid,
+									std::vector< Edge >& aConnections)
 	{
-		static const int xOffset[] = { 0, 1, 1, 1, 0, -1, -1, -1 };
-		static const int yOffset[] = { 1, 1, 0, -1, -1, -1, 0, 1 };
-
-		const std::vector< Model::WallPtr >& walls = Model::RobotWorld::getRobotWorld().getWalls();
-		std::vector< Vertex > neighbours;
-
-		for (int i = 0; i < 8; ++i)
+		aConnections.clear();
+		for (int i = 0; i < EightConnected::moves; ++i)
 		{
-			bool addToNeigbours = true;
-
-			Vertex vertex( aVertex.x + xOffset[i], aVertex.y + yOffset[i]);
-			for (Model::WallPtr wall : walls)
+			int x = aVertex.x + EightConnected::xOffset[i];
+			int y = aVertex.y + EightConnected::yOffset[i];
+			if (!anOccupancyGrid.isBlocked( x, y))
 			{
-				if (Utils::Shape2DUtils::isOnLine( wall->getPoint1(), wall->getPoint2(), vertex.asPoint(), aFreeRadius))
-				{
-					addToNeigbours = false;
-					break;
-				}
-			}
-			if (addToNeigbours == true)
-			{
-				neighbours.push_back( vertex);
+				aConnections.push_back( Edge( aVertex, Vertex( x, y)));
 			}
 		}
-		return neighbours;
+	}
+	/**
+	 * The extent of the walls, the start and the goal with enough space around it
+	 * to let the robot pass around the end of every wall
+	 */
+	GridExtent GetSearchExtent(	const Vertex& aStart,
+								const Vertex& aGoal,
+								int aFreeRadius,
+								const WallSnapshot& aWallSnapshot)
+	{
+		GridExtent extent = GridExtent::fromCorners( aStart.asPoint(), aGoal.asPoint()).united( aWallSnapshot.getExtent());
+		return extent.inflated( 2 * aFreeRadius + 2);
 	}
 	/**
 	 *
 	 */
-	std::vector< Edge > GetNeighbourConnections(	const Vertex& aVertex,
-													int aFreeRadius /*= 1*/)
+	AStar::AStar() :
+				storageMode( GridStorage),
+				searchDirection( Forward),
+				meetPoint( 0, 0),
+				forwardExpansions( 0),
+				backwardExpansions( 0)
 	{
-		std::vector< Edge > connections;
-
-		const std::vector< Vertex >& neighbours = GetNeighbours( aVertex, aFreeRadius);
-		for (const Vertex& vertex : neighbours)
-		{
-			connections.push_back( Edge( aVertex, vertex));
-		}
-
-		return connections;
 	}
 	/**
 	 *
@@ -106,7 +98,8 @@ namespace PathAlgorithm
 		Vertex start( aStartPoint);
 		Vertex goal( aGoalPoint);
 
-		Path path = AStar::search( start, goal, aRobotSize);
+		Path path;
+		searchPath( start, goal, aRobotSize, path, searchDirection);
 		return path;
 	}
 	/**
@@ -114,81 +107,148 @@ namespace PathAlgorithm
 	 */
 	Path AStar::search( Vertex aStart,
 						const Vertex& aGoal,
-						const wxSize& aRobotSize)
+						const wxSize& aRobotSize,
+						SearchDirection aSearchDirection)
+	{
+		Path path;
+		searchPath( aStart, aGoal, aRobotSize, path, aSearchDirection);
+		return path;
+	}
+	/**
+	 *
+	 */
+	bool AStar::searchPath(	const wxPoint& aStartPoint,
+							const wxPoint& aGoalPoint,
+							const wxSize& aRobotSize,
+							Path& aPath)
 	{
+		return searchPath( Vertex( aStartPoint), Vertex( aGoalPoint), aRobotSize, aPath, searchDirection);
+	}
+	/**
+	 *
+	 */
+	bool AStar::searchPath(	Vertex aStart,
+							const Vertex& aGoal,
+							const wxSize& aRobotSize,
+							Path& aPath,
+							SearchDirection aSearchDirection)
+	{
+		aPath.clear();
+		expansions = 0;
+		beginProgress();
+		forwardExpansions = 0;
+		backwardExpansions = 0;
+		meetPoint = aGoal;
+
 		getOS().clear();
 		getCS().clear();
 		getPM().clear();
 
-		int radius = static_cast<int>(std::ceil(std::sqrt( ((aRobotSize.x+1) / 2.0) * ((aRobotSize.x+1) / 2.0) + ((aRobotSize.y+1) / 2.0) * ((aRobotSize.y+1) / 2.0))));
+		int radius = getFreeRadius( aRobotSize);
+
+		prepareSearch( aStart, aGoal, radius);
+
+		searchExtent = GetSearchExtent( aStart, aGoal, radius, *getWallSnapshot());
+		if (storageMode == GridStorage)
+		{
+			grid.reset( searchExtent);
+			getOS().setKeyFunction( VertexPointKey( searchExtent));
+			getOS().setDenseKeys( searchExtent.size());
+		} else
+		{
+			grid.reset( GridExtent());
+			getOS().setKeyFunction( VertexPointKey());
+			getOS().setDenseKeys( 0);
+		}
+		backwardOpenSet.clear();
+		backwardGrid.reset( GridExtent());
 
 		aStart.actualCost = 0.0; 													// Cost from aStart along the best known path.
 		aStart.heuristicCost = aStart.actualCost + HeuristicCost( aStart, aGoal);	// Estimated total cost from aStart to aGoal through y.
 
 		addToOpenSet(aStart);
 
+		if (aSearchDirection == Bidirectional && storageMode == GridStorage && hasReversibleConnections())
+		{
+			return searchBidirectional( aStart, aGoal, aPath);
+		}
+
 		// Keep the timing stuff, please.
 //		clock_t start = std::clock();
 		while (!openSet.empty())
 		{
-			// The openSet should be sorted by cost, least cost must be the first
-			Vertex current = *openSet.begin();
+			if (isCancelled())
+			{
+				forwardExpansions = expansions;
+				return false;
+			}
+
+			// The openSet is a heap ordered by cost, least cost is on top
+			Vertex current = openSet.top();
 
 			if (current.equalPoint( aGoal))
 			{
 //				clock_t end = std::clock();
 //				std::cout << "Duration: " << static_cast<double>(end - start)/CLOCKS_PER_SEC <<	", openSet: " << openSet.size() <<  ", closedSet: " << closedSet.size() << ", predecessorMap: " << predecessorMap.size() << std::endl;
-				return ConstructPath( predecessorMap, current);
+				forwardExpansions = expansions;
+				meetPoint = current;
+				constructPath( current, aPath);
+				publishProgress();
+				return true;
 			} else
 			{
 				removeFirstFromOpenSet();
 				addToClosedSet( current);
+				++expansions;
+				reportProgress();
 
 				// Find all the outgoing connections for the current Vertex
-				const std::vector< Edge >& connections = GetNeighbourConnections( current, radius);
+				getConnections( current, aGoal, connections);
 
 				for (const Edge& connection : connections)
 				{
 					Vertex neighbour = connection.otherSide( current);
+					if (isOutsideGrid( neighbour))
+					{
+						continue;
+					}
 
 					// Calculate the cost for the newly found neighbour
 					neighbour.actualCost = current.actualCost + ActualCost( current, neighbour);
 					neighbour.heuristicCost = neighbour.actualCost + HeuristicCost( neighbour, aGoal);
 
 					// The neighbour may already be in the openSet because of the previous current Vertex iteration
-					OpenSet::iterator openVertex = findInOpenSet( neighbour);
-					if (openVertex != openSet.end())
+					std::size_t openVertex = findInOpenSet( neighbour);
+					if (openVertex != VertexHeap::npos)
 					{
 						// if neighbour is in the openSet we may have found a shorter via-route
 						// than via the previous current Vertex
-						if ((*openVertex).heuristicCost <= neighbour.heuristicCost)
+						if (openSet.at( openVertex).heuristicCost <= neighbour.heuristicCost)
 						{
 							// Do nothing
 							continue;
 						} else
 						{
-							// Update the cost
-							// TODO: should the actual cost be adjusted if (*openVertex).heuristicCost < neighbour.actualCost?
-							//(*openVertex).actualCost = neighbour.actualCost;
-							(*openVertex).heuristicCost = neighbour.heuristicCost;
+							// Decrease the key: the cost and the route both go via the current Vertex
+							updateInOpenSet( openVertex, neighbour);
+							setPredecessor( neighbour, current);
 							continue;
 						}
 					}
 
 					// The neighbour may be re-opened because we found a shorter via-route
-					ClosedSet::iterator closedVertex = findInClosedSet( neighbour);
-					if (closedVertex != closedSet.end())
+					double closedCost;
+					if (findInClosedSet( neighbour, closedCost))
 					{
-						// if neighbour is in the closedSet we may have found a shorter via-route
-						if ((*closedVertex).heuristicCost <= neighbour.heuristicCost)
+						// if neighbour is in the closedSet we may have found a shorter via-route,
+						// the heuristic is the same so comparing the actual cost is enough
+						if (closedCost <= neighbour.actualCost)
 						{
 							// Do nothing
 							continue;
 						} else
 						{
-							std::cout << "remove" << std::endl;
-							addToOpenSet( *closedVertex);
-							removeFromClosedSet( closedVertex);
+							removeFromClosedSet( neighbour);
 						}
 					}
 
@@ -196,11 +256,7 @@ namespace PathAlgorithm
 					addToOpenSet( neighbour);
 
 					// Add or replace (assign) the route elements.
-					const auto& [iterator, succes] = predecessorMap.insert_or_assign( neighbour, current);
-					if(!succes)
-					{
-						std::cerr << "**** Failed adding neighbour to the predecessorMap: " << neighbour << std::endl;
-					}
+					setPredecessor( neighbour, current);
 
 				} //for(Edge connection : connections)
 
@@ -223,15 +279,6 @@ namespace PathAlgorithm
 				//			aRobotSize = (37,29), radius = 23
 				//			Duration: 2.626.220 openSet: 1507 closedSet: 76521 predecessorMap: 78027
 				//
-				//			// Sort the openSet before the next loop, use partial_sort as per Scott Meyers' Effective STL
-				//			if(std::distance(openSet.begin(), openSet.end()) > 5 )
-				//			{
-				//				std::partial_sort( openSet.begin(), openSet.begin() + 4, openSet.end(), VertexLessCostCompare());
-				//			}else
-				//			{
-				//				std::sort( openSet.begin(), openSet.end(), VertexLessCostCompare());
-				//			}
-				//
 				//			 28-1-2022:
 				//
 				//			 Some rationalisations (see a diff for the differences) and the size of the window has changed.
@@ -244,106 +291,350 @@ namespace PathAlgorithm
 				//			   	Duration: 0.487936, openSet: 1252, closedSet: 83731, predecessorMap: 84982
 				//			   Without profiling information:
 				//			   	Duration: 0.294032, openSet: 1252, closedSet: 83731, predecessorMap: 84982
-				std::iter_swap(openSet.begin(), std::min_element( openSet.begin(), openSet.end(), VertexLessCostCompare()));
+				//
+				//			 18-10-2026:
+				//
+				//			 The vector was still scanned twice per expansion: std::min_element for the next current Vertex
+				//			 and find_if for every neighbour. The openSet is now a 4-ary heap with a position index, which
+				//			 gives O(1) lookup and O(log n) pop and decrease-key. A decrease-key now also updates the
+				//			 actual cost and the predecessor, the vector version only lowered the total cost.
+				//			 aRobotSize = (37,29), radius = 23, -O2, median of 5 runs, RobotWorld::populate cases:
+				//			   world 0:	vector 0.287, heap 0.294
+				//			   world 5:	vector 0.648, heap 0.492
+				//			   world 7:	vector 0.669, heap 0.505
+				//			   world 9:	vector 0.104, heap 0.097 (and a shorter path because of the decrease-key fix)
+				//			 With an openSet of ~1000 vertices the scans were not the bottleneck in world 0, the time
+				//			 now goes to GetNeighbours (all walls for all neighbours) and the closedSet/predecessorMap.
+				//
+				//			 With GridStorage (flat closed/cost/parent arrays, dense open set index) instead of the
+				//			 std::set/std::map nodes, same cases:
+				//			   world 0: 0.082, world 5: 0.137, world 7: 0.158, world 9: 0.041
+				//
+				//			 GetNeighbours does a single OccupancyGrid lookup instead of an isOnLine test against all walls.
+				//			 The grid is only rebuilt if the walls or the radius change (~6 ms for the stock worlds), repeated
+				//			 searches with the same AStar:
+				//			   world 0: 0.050, world 5: 0.084, world 7: 0.087, world 9: 0.023
+				//
+				//			 The open and closed set functions notified the observers for every vertex, ~180.000 times for
+				//			 world 0. With an observer that reads the open set that took 0.099, the search notifies every
+				//			 40 ms (Planner::reportProgress) now and takes 0.019 with the same observer.
 			}
 		}
 
+		forwardExpansions = expansions;
+		publishProgress();
 		std::cerr << "**** No route from " << aStart << " to " << aGoal << std::endl;
-		return Path();
+		return false;
+	}
+	/**
+	 *
+	 */
+	bool AStar::searchBidirectional(	const Vertex& aStart,
+										const Vertex& aGoal,
+										Path& aPath)
+	{
+		// A route may leave a blocked start but never enter a blocked cell, so a blocked goal cannot be reached
+		if (!aStart.equalPoint( aGoal) && occupancyGrid.isBlocked( aGoal.x, aGoal.y))
+		{
+			std::cerr << "**** No route from " << aStart << " to " << aGoal << std::endl;
+			return false;
+		}
+
+		backwardGrid.reset( searchExtent);
+		backwardOpenSet.setKeyFunction( VertexPointKey( searchExtent));
+		backwardOpenSet.setDenseKeys( searchExtent.size());
+
+		Vertex goal( aGoal.x, aGoal.y);
+		goal.actualCost = 0.0;
+		goal.heuristicCost = HeuristicCost( goal, aStart);
+		backwardOpenSet.push( goal);
+		std::uint32_t goalIndex = searchExtent.index( goal.x, goal.y);
+		backwardGrid.setState( goalIndex, SearchGrid::Open);
+		backwardGrid.setActualCost( goalIndex, 0.0);
+		backwardGrid.setParent( goalIndex, SearchGrid::noParent);
+
+		double bestCost = std::numeric_limits< double >::infinity();
+		std::uint32_t meetIndex = SearchGrid::noParent;
+		if (aStart.equalPoint( aGoal))
+		{
+			bestCost = 0.0;
+			meetIndex = goalIndex;
+		}
+
+		// With a consistent heuristic the top of either open set is a lower bound on the cost of any route that
+		// is not known yet, so the best route found so far is optimal as soon as either top is not cheaper than it.
+		// The costs are sums of square roots, on a straight diagonal the tops equal the best cost up to rounding.
+		// The side with the smaller open set is expanded first, which keeps the two frontiers about equally large.
+		while (!openSet.empty() && !backwardOpenSet.empty())
+		{
+			if (isCancelled())
+			{
+				expansions = forwardExpansions + backwardExpansions;
+				return false;
+			}
+			if (std::max( openSet.top().heuristicCost, backwardOpenSet.top().heuristicCost) >= bestCost - costTolerance)
+			{
+				break;
+			}
+			if (openSet.size() <= backwardOpenSet.size())
+			{
+				expandTowards( aGoal, openSet, grid, backwardGrid, bestCost, meetIndex);
+				++forwardExpansions;
+			} else
+			{
+				expandTowards( aStart, backwardOpenSet, backwardGrid, grid, bestCost, meetIndex);
+				++backwardExpansions;
+			}
+			reportProgress();
+		}
+		expansions = forwardExpansions + backwardExpansions;
+		publishProgress();
+
+		if (meetIndex == SearchGrid::noParent)
+		{
+			std::cerr << "**** No route from " << aStart << " to " << aGoal << std::endl;
+			return false;
+		}
+
+		meetPoint = Vertex( searchExtent.xOf( meetIndex), searchExtent.yOf( meetIndex));
+		meetPoint.actualCost = grid.getActualCost( meetIndex);
+
+		// The forward half from the start up to and including the meet point, the backward half from there to the goal
+		std::size_t forwardLength = 1;
+		for (std::uint32_t index = grid.getParent( meetIndex); index != SearchGrid::noParent; index = grid.getParent( index))
+		{
+			++forwardLength;
+		}
+		std::size_t backwardLength = 0;
+		for (std::uint32_t index = backwardGrid.getParent( meetIndex); index != SearchGrid::noParent; index = backwardGrid.getParent( index))
+		{
+			++backwardLength;
+		}
+
+		aPath.assign( forwardLength + backwardLength, meetPoint);
+		std::size_t position = forwardLength;
+		for (std::uint32_t index = meetIndex; index != SearchGrid::noParent; index = grid.getParent( index))
+		{
+			Vertex& vertex = aPath[--position];
+			vertex.x = searchExtent.xOf( index);
+			vertex.y = searchExtent.yOf( index);
+			vertex.actualCost = grid.getActualCost( index);
+			vertex.heuristicCost = 0.0;
+		}
+		position = forwardLength;
+		for (std::uint32_t index = backwardGrid.getParent( meetIndex); index != SearchGrid::noParent; index = backwardGrid.getParent( index))
+		{
+			Vertex& vertex = aPath[position++];
+			vertex.x = searchExtent.xOf( index);
+			vertex.y = searchExtent.yOf( index);
+			vertex.actualCost = bestCost - backwardGrid.getActualCost( index);
+			vertex.heuristicCost = 0.0;
+		}
+		aPath.back().heuristicCost = aPath.back().actualCost;
+		return true;
+	}
+	/**
+	 *
+	 */
+	void AStar::expandTowards(	const Vertex& aTarget,
+								VertexHeap& anOpenSet,
+								SearchGrid& aGrid,
+								const SearchGrid& anOtherGrid,
+								double& aBestCost,
+								std::uint32_t& aMeetIndex)
+	{
+		Vertex current = anOpenSet.top();
+		anOpenSet.pop();
+		std::uint32_t currentIndex = searchExtent.index( current.x, current.y);
+		aGrid.setState( currentIndex, SearchGrid::Closed);
+
+		// The other search has expanded this vertex already and the route through it was
+		// considered when it was reached, expanding it again cannot lead to a cheaper route
+		if (anOtherGrid.isClosed( currentIndex))
+		{
+			return;
+		}
+
+		getConnections( current, aTarget, connections);
+		for (const Edge& connection : connections)
+		{
+			Vertex neighbour = connection.otherSide( current);
+			if (!searchExtent.contains( neighbour.x, neighbour.y))
+			{
+				continue;
+			}
+
+			std::uint32_t index = searchExtent.index( neighbour.x, neighbour.y);
+			SearchGrid::CellState state = aGrid.getState( index);
+			double actualCost = current.actualCost + ActualCost( current, neighbour);
+			if (state != SearchGrid::Unvisited && aGrid.getActualCost( index) <= actualCost)
+			{
+				continue;
+			}
+
+			neighbour.actualCost = actualCost;
+			neighbour.heuristicCost = actualCost + HeuristicCost( neighbour, aTarget);
+			if (neighbour.heuristicCost >= aBestCost - costTolerance)
+			{
+				// Every route through the neighbour is at least as expensive as the best one
+				continue;
+			}
+			aGrid.setActualCost( index, actualCost);
+			aGrid.setParent( index, currentIndex);
+			if (state == SearchGrid::Open)
+			{
+				anOpenSet.update( anOpenSet.find( neighbour), neighbour);
+			} else
+			{
+				anOpenSet.push( neighbour);
+				aGrid.setState( index, SearchGrid::Open);
+			}
+
+			if (anOtherGrid.getState( index) != SearchGrid::Unvisited && actualCost + anOtherGrid.getActualCost( index) < aBestCost)
+			{
+				aBestCost = actualCost + anOtherGrid.getActualCost( index);
+				aMeetIndex = index;
+			}
+		}
 	}
 	/**
 	 *
 	 */
 	void AStar::addToOpenSet( const Vertex& aVertex)
 	{
-		openSet.push_back( aVertex);
-		notifyObservers();
+		openSet.push( aVertex);
+		if (storageMode == GridStorage)
+		{
+			std::uint32_t index = grid.getExtent().index( aVertex.x, aVertex.y);
+			grid.setState( index, SearchGrid::Open);
+			grid.setActualCost( index, aVertex.actualCost);
+			grid.setParent( index, SearchGrid::noParent);
+		}
 	}
 	/**
 	 *
 	 */
 	void AStar::removeFromOpenSet( const Vertex& aVertex)
 	{
-		OpenSet::iterator i = findInOpenSet( aVertex);
-		removeFromOpenSet( i);
+		removeFromOpenSet( findInOpenSet( aVertex));
 	}
 	/**
 	 *
 	 */
-	void AStar::removeFromOpenSet( OpenSet::iterator& i)
+	void AStar::removeFromOpenSet( std::size_t aPosition)
 	{
-		openSet.erase( i);
-		notifyObservers();
+		openSet.erase( aPosition);
 	}
 	/**
 	 *
 	 */
-	OpenSet::iterator AStar::findInOpenSet( const Vertex& aVertex)
+	std::size_t AStar::findInOpenSet( const Vertex& aVertex) const
 	{
-		return std::find_if( openSet.begin(),
-							 openSet.end(),
-							 [aVertex](const Vertex& rhs)
-							 {
-								return aVertex.equalPoint(rhs);
-							 });
+		return openSet.find( aVertex);
 	}
 	/**
 	 *
 	 */
-	bool AStar::findRemoveInOpenSet( const Vertex& aVertex)
+	void AStar::updateInOpenSet(	std::size_t aPosition,
+									const Vertex& aVertex)
 	{
-		OpenSet::iterator i = findInOpenSet( aVertex);
-		if (i != openSet.end())
+		openSet.update( aPosition, aVertex);
+		if (storageMode == GridStorage)
 		{
-			openSet.erase( i);
-			return true;
+			grid.setActualCost( grid.getExtent().index( aVertex.x, aVertex.y), aVertex.actualCost);
 		}
-		return false;
-
 	}
 	/**
 	 *
 	 */
-	void AStar::removeFirstFromOpenSet()
+	bool AStar::findRemoveInOpenSet( const Vertex& aVertex)
 	{
-		openSet.erase( openSet.begin());
+		return openSet.erase( aVertex);
 	}
 	/**
 	 *
 	 */
-	void AStar::addToClosedSet( const Vertex& aVertex)
+	void AStar::removeFirstFromOpenSet()
 	{
-		closedSet.insert( aVertex);
-		notifyObservers();
+		openSet.pop();
 	}
 	/**
 	 *
 	 */
-	void AStar::removeFromClosedSet( const Vertex& aVertex)
+	void AStar::addToClosedSet( const Vertex& aVertex)
 	{
-		ClosedSet::iterator i = findInClosedSet( aVertex);
-		removeFromClosedSet( i);
+		if (storageMode == GridStorage)
+		{
+			std::uint32_t index = grid.getExtent().index( aVertex.x, aVertex.y);
+			grid.setState( index, SearchGrid::Closed);
+			grid.setActualCost( index, aVertex.actualCost);
+		} else
+		{
+			closedSet.insert( aVertex);
+		}
 	}
 	/**
 	 *
 	 */
-	void AStar::removeFromClosedSet( ClosedSet::iterator& i)
+	void AStar::removeFromClosedSet( const Vertex& aVertex)
 	{
-		closedSet.erase( i);
-		notifyObservers();
+		findRemoveClosedSet( aVertex);
 	}
 	/**
 	 *
 	 */
-	ClosedSet::iterator AStar::findInClosedSet( const Vertex& aVertex)
+	bool AStar::findInClosedSet(	const Vertex& aVertex,
+									double& anActualCost) const
 	{
-		return closedSet.find( aVertex);
+		if (storageMode == GridStorage)
+		{
+			std::uint32_t index = grid.getExtent().index( aVertex.x, aVertex.y);
+			if (grid.isClosed( index))
+			{
+				anActualCost = grid.getActualCost( index);
+				return true;
+			}
+			return false;
+		}
+
+		ClosedSet::const_iterator i = closedSet.find( aVertex);
+		if (i != closedSet.end())
+		{
+			anActualCost = (*i).actualCost;
+			return true;
+		}
+		return false;
 	}
 	/**
 	 *
 	 */
 	ClosedSet AStar::getClosedSet() const
 	{
+		if (storageMode == GridStorage)
+		{
+			ClosedSet snapshot;
+			const GridExtent& extent = grid.getExtent();
+			for (std::uint32_t index = 0; index < extent.size(); ++index)
+			{
+				if (grid.isClosed( index))
+				{
+					Vertex vertex( extent.xOf( index), extent.yOf( index));
+					vertex.actualCost = grid.getActualCost( index);
+					snapshot.insert( snapshot.end(), vertex);
+				}
+			}
+			const GridExtent& backwardExtent = backwardGrid.getExtent();
+			for (std::uint32_t index = 0; index < backwardExtent.size(); ++index)
+			{
+				if (backwardGrid.isClosed( index))
+				{
+					Vertex vertex( backwardExtent.xOf( index), backwardExtent.yOf( index));
+					vertex.actualCost = backwardGrid.getActualCost( index);
+					snapshot.insert( vertex);
+				}
+			}
+			return snapshot;
+		}
 		return closedSet;
 	}
 	/**
@@ -351,7 +642,18 @@ namespace PathAlgorithm
 	 */
 	bool AStar::findRemoveClosedSet( const Vertex& aVertex)
 	{
-		ClosedSet::iterator i = findInClosedSet( aVertex);
+		if (storageMode == GridStorage)
+		{
+			std::uint32_t index = grid.getExtent().index( aVertex.x, aVertex.y);
+			if (grid.isClosed( index))
+			{
+				grid.setState( index, SearchGrid::Open);
+				return true;
+			}
+			return false;
+		}
+
+		ClosedSet::iterator i = closedSet.find( aVertex);
 		if (i != closedSet.end())
 		{
 			closedSet.erase( i);
@@ -364,15 +666,134 @@ namespace PathAlgorithm
 	 */
 	OpenSet AStar::getOpenSet() const
 	{
-		return openSet;
+		OpenSet snapshot( openSet.begin(), openSet.end());
+		snapshot.insert( snapshot.end(), backwardOpenSet.begin(), backwardOpenSet.end());
+		return snapshot;
 	}
 	/**
 	 *
 	 */
 	VertexMap AStar::getPredecessorMap() const
 	{
+		if (storageMode == GridStorage)
+		{
+			VertexMap snapshot;
+			const GridExtent& extent = grid.getExtent();
+			for (std::uint32_t index = 0; index < extent.size(); ++index)
+			{
+				std::uint32_t parent = grid.getParent( index);
+				if (grid.getState( index) != SearchGrid::Unvisited && parent != SearchGrid::noParent)
+				{
+					snapshot.insert_or_assign( Vertex( extent.xOf( index), extent.yOf( index)), Vertex( extent.xOf( parent), extent.yOf( parent)));
+				}
+			}
+			return snapshot;
+		}
 		return predecessorMap;
 	}
+	/**
+	 *
+	 */
+	void AStar::prepareSearch(	const Vertex& UNUSEDPARAM(aStart),
+								const Vertex& UNUSEDPARAM(aGoal),
+								int aFreeRadius)
+	{
+		// The clearance map is shared by all robots, the occupancy grid for this radius is only
+		// derived again if the walls have changed or if the radius is different
+		WallSnapshotPtr wallSnapshot = getWallSnapshot();
+		if (!occupancyGrid.isBuiltFor( aFreeRadius, wallSnapshot->getWallsVersion()))
+		{
+			occupancyGrid.build( *wallSnapshot->getClearanceMap( aFreeRadius), aFreeRadius);
+		}
+	}
+	/**
+	 *
+	 */
+	void AStar::getConnections(	const Vertex& aVertex,
+								const Vertex& UNUSEDPARAM(aGoal),
+								std::vector< Edge >& aConnections)
+	{
+		GetNeighbourConnections( aVertex, occupancyGrid, aConnections);
+	}
+	/**
+	 *
+	 */
+	bool AStar::findPredecessor(	const Vertex& aVertex,
+									Vertex& aPredecessor) const
+	{
+		if (storageMode == GridStorage)
+		{
+			const GridExtent& extent = grid.getExtent();
+			std::uint32_t parent = grid.getParent( extent.index( aVertex.x, aVertex.y));
+			if (parent == SearchGrid::noParent)
+			{
+				return false;
+			}
+			aPredecessor = Vertex( extent.xOf( parent), extent.yOf( parent));
+			return true;
+		}
+
+		VertexMap::const_iterator i = predecessorMap.find( aVertex);
+		if (i != predecessorMap.end())
+		{
+			aPredecessor = (*i).second;
+			return true;
+		}
+		return false;
+	}
+	/**
+	 *
+	 */
+	bool AStar::isOutsideGrid( const Vertex& aVertex) const
+	{
+		return storageMode == GridStorage && !grid.getExtent().contains( aVertex.x, aVertex.y);
+	}
+	/**
+	 *
+	 */
+	void AStar::setPredecessor(	const Vertex& aVertex,
+								const Vertex& aPredecessor)
+	{
+		if (storageMode == GridStorage)
+		{
+			const GridExtent& extent = grid.getExtent();
+			grid.setParent( extent.index( aVertex.x, aVertex.y), extent.index( aPredecessor.x, aPredecessor.y));
+		} else
+		{
+			predecessorMap.insert_or_assign( aVertex, aPredecessor);
+		}
+	}
+	/**
+	 *
+	 */
+	void AStar::constructPath(	const Vertex& aGoal,
+								Path& aPath)
+	{
+		if (storageMode != GridStorage)
+		{
+			ConstructPath( predecessorMap, aGoal, aPath);
+			return;
+		}
+
+		// Count the vertices from the goal back to the start (which has no parent) and fill the path from the back
+		const GridExtent& extent = grid.getExtent();
+		std::size_t length = 1;
+		for (std::uint32_t index = grid.getParent( extent.index( aGoal.x, aGoal.y)); index != SearchGrid::noParent; index = grid.getParent( index))
+		{
+			++length;
+		}
+
+		aPath.assign( length, aGoal);
+		std::size_t position = length - 1;
+		for (std::uint32_t index = grid.getParent( extent.index( aGoal.x, aGoal.y)); index != SearchGrid::noParent; index = grid.getParent( index))
+		{
+			Vertex& vertex = aPath[--position];
+			vertex.x = extent.xOf( index);
+			vertex.y = extent.yOf( index);
+			vertex.actualCost = grid.getActualCost( index);
+			vertex.heuristicCost = 0.0;
+		}
+	}
 
 	/**
 	 *
@@ -391,14 +812,14 @@ namespace PathAlgorithm
 	/**
 	 *
 	 */
-	OpenSet& AStar::getOS()
+	VertexHeap& AStar::getOS()
 	{
 		return openSet;
 	}
 	/**
 	 *
 	 */
-	const OpenSet& AStar::getOS() const
+	const VertexHeap& AStar::getOS() const
 	{
 		return openSet;
 	}
@@ -3,222 +3,200 @@
 
 #include "Config.hpp"
 
-#include "Notifier.hpp"
-#include "Point.hpp"
+#include "GridExtent.hpp"
+#include "IndexedHeap.hpp"
+#include "OccupancyGrid.hpp"
+#include "Planner.hpp"
+#include "SearchGrid.hpp"
 
-#include <iostream>
-#include <map>
+#include <cstdint>
 #include <mutex>
-#include <set>
-#include <vector>
 
 
 namespace PathAlgorithm
 {
 	/**
-	 * A Vertex is the dot in a graph.
+	 * Gives every point a unique key, used to find a Vertex in the open set. If an extent is given
+	 * the key is the (dense) cell index in that extent. Otherwise both coordinates are packed in 64 bits,
+	 * where std::size_t has 32 bits only the low 16 bits of each coordinate are kept, which keeps the key
+	 * unique from -32768 up to 32767.
 	 */
-	struct Vertex
+	struct VertexPointKey
 	{
 			/**
 			 *
 			 */
-			Vertex( int anX,
-					int anY) :
-						x( anX),
-						y( anY),
-						actualCost( 0.0),
-						heuristicCost( 0.0)
+			VertexPointKey() = default;
+			/**
+			 *
+			 */
+			explicit VertexPointKey( const GridExtent& anExtent) :
+				extent( anExtent)
 			{
 			}
 			/**
 			 *
 			 */
-			explicit Vertex( const wxPoint& aPoint) :
-				x( aPoint.x),
-				y( aPoint.y),
-				actualCost( 0.0),
-				heuristicCost( 0.0)
+			std::size_t operator()( const Vertex& aVertex) const
 			{
+				if (extent.empty())
+				{
+					std::uint64_t key = (static_cast< std::uint64_t >( static_cast< std::uint32_t >( aVertex.x)) << 32) | static_cast< std::uint32_t >( aVertex.y);
+					if (sizeof( std::size_t) < sizeof( std::uint64_t))
+					{
+						key = ((key >> 16) & 0xFFFF0000ULL) | (key & 0xFFFFULL);
+					}
+					return static_cast< std::size_t >( key);
+				}
+				return extent.index( aVertex.x, aVertex.y);
 			}
+
+			GridExtent extent;
+	};
+	// struct VertexPointKey
+
+	/*
+	 *
+	 */
+	typedef Base::IndexedHeap< Vertex, VertexLessCostCompare, VertexPointKey > VertexHeap;
+	/**
+	 * The extent of the walls, the start and the goal with enough space around it
+	 * to let the robot pass around the end of every wall
+	 */
+	GridExtent GetSearchExtent(	const Vertex& aStart,
+								const Vertex& aGoal,
+								int aFreeRadius,
+								const WallSnapshot& aWallSnapshot);
+	/**
+	 *
+	 */
+	class AStar : public Planner
+	{
+		public:
 			/**
-			 *
+			 * How the closed set, the actual costs and the predecessors are stored during a search
 			 */
-			 Vertex( const Vertex&) = default;
+			enum StorageMode
+			{
+				/**
+				 * std::set and std::map, one node per Vertex. The search is not bounded.
+				 */
+				NodeStorage,
+				/**
+				 * Flat arrays over the extent of the walls, the start and the goal (see SearchGrid).
+				 * The search does not leave that extent.
+				 */
+				GridStorage
+			};
 			/**
 			 *
 			 */
-			 Vertex( Vertex&&) = default;
+			enum SearchDirection
+			{
+				/**
+				 * From the start to the goal
+				 */
+				Forward,
+				/**
+				 * From both the start and the goal until the best meet point is known to be optimal.
+				 * Only in GridStorage mode and only if the connections are reversible, otherwise
+				 * the search is a Forward search.
+				 */
+				Bidirectional
+			};
 			/**
 			 *
 			 */
-			 Vertex& operator=( const Vertex&) = default;
+			AStar();
 			/**
 			 *
 			 */
-			wxPoint asPoint() const
+			StorageMode getStorageMode() const
 			{
-				return wxPoint( x, y);
+				return storageMode;
 			}
 			/**
 			 *
 			 */
-			bool lessCost( const Vertex& aVertex) const
+			void setStorageMode( StorageMode aStorageMode)
 			{
-				if (heuristicCost < aVertex.heuristicCost)
-					return true;
-				// less uncertainty if the actual cost is smaller
-				if (heuristicCost == aVertex.heuristicCost)
-					return actualCost > aVertex.actualCost;
-				return false;
+				storageMode = aStorageMode;
 			}
 			/**
-			 *
+			 * The direction of the searches that do not get a direction, Forward by default
 			 */
-			bool lessId( const Vertex& aVertex) const
+			SearchDirection getSearchDirection() const
 			{
-				if ( x < aVertex.x) return true;
-				if ( x == aVertex.x) return y < aVertex.y;
-				return false;
+				return searchDirection;
 			}
 			/**
 			 *
 			 */
-			bool equalPoint( const Vertex& aVertex) const
+			void setSearchDirection( SearchDirection aSearchDirection)
 			{
-				return x == aVertex.x && y == aVertex.y;
+				searchDirection = aSearchDirection;
 			}
-
-			int x;
-			int y;
-
-			double actualCost;
-			double heuristicCost;
-	};
-	// struct Vertex
-
-	/**
-	 *
-	 */
-	struct VertexLessCostCompare
-	{
-			bool operator()(	const Vertex& lhs,
-								const Vertex& rhs) const
-			{
-				return lhs.lessCost( rhs);
-			}
-	};
-	// struct VertexCostCompare
-	/**
-	 *
-	 */
-	struct VertexLessIdCompare
-	{
-			bool operator()(	const Vertex& lhs,
-								const Vertex& rhs) const
-			{
-				return lhs.lessId( rhs);
-			}
-	};
-	// struct VertexIdCompare
-	/**
-	 *
-	 */
-	struct VertexEqualPointCompare
-	{
-			bool operator()(	const Vertex& lhs,
-								const Vertex& rhs) const
-			{
-				return lhs.equalPoint( rhs);
-			}
-	};
-	// struct VertexPointCompare
-
-	/**
-	 * An edge is a line between dots…
-	 */
-	struct Edge
-	{
-			Edge(	const Vertex& aVertex1,
-					const Vertex& aVertex2) :
-						vertex1( aVertex1),
-						vertex2( aVertex2)
-			{
-			}
-			Edge( const Edge& anEdge) :
-				vertex1( anEdge.vertex1),
-				vertex2( anEdge.vertex2)
-			{
-			}
-
-			const Vertex& thisSide( const Vertex& aVertex) const
-			{
-				if (vertex1.equalPoint( aVertex))
-					return vertex1;
-				if (vertex2.equalPoint( aVertex))
-					return vertex2;
-				throw std::logic_error( "thisSide: huh???");
-			}
-
-			const Vertex& otherSide( const Vertex& aVertex) const
+			/**
+			 *
+			 */
+			virtual std::string getCacheKey() const override
 			{
-				if (vertex1.equalPoint( aVertex))
-					return vertex2;
-				if (vertex2.equalPoint( aVertex))
-					return vertex1;
-				throw std::logic_error( "otherSide: huh???");
+				return Planner::getCacheKey() + " " + std::to_string( storageMode) + " " + std::to_string( searchDirection);
 			}
-
-			Vertex vertex1;
-			Vertex vertex2;
-	}; // struct Edge
-	/**
-	 *
-	 * @param os
-	 * @param aVertex
-	 * @return
-	 */
-	inline std::ostream& operator<<( 	std::ostream& os,
-										const Vertex & aVertex)
-	{
-		return os << "(" << aVertex.x << "," << aVertex.y << "), " << aVertex.actualCost << " " << aVertex.heuristicCost;
-	}
-	/**
-	 *
-	 * @param os
-	 * @param anEdge
-	 * @return
-	 */
-	inline std::ostream& operator<<( 	std::ostream& os,
-										const Edge& anEdge)
-	{
-		return os << anEdge.vertex1 << " -> " << anEdge.vertex2;
-	}
-	/*
-	 *
-	 */
-	typedef std::vector< Vertex > Path;
-	typedef std::vector< Vertex > OpenSet;
-	typedef std::set< Vertex, VertexLessIdCompare > ClosedSet;
-	typedef std::map< Vertex, Vertex, VertexLessIdCompare > VertexMap;
-	/**
-	 *
-	 */
-	class AStar : public Base::Notifier
-	{
-		public:
 			/**
 			 *
 			 */
-			Path search(const wxPoint& aStartPoint,
-						const wxPoint& aGoalPoint,
-						const wxSize& aRobotSize);
+			virtual Path search(const wxPoint& aStartPoint,
+								const wxPoint& aGoalPoint,
+								const wxSize& aRobotSize) override;
 			/**
 			 *
 			 */
 			Path search(Vertex aStart,
 						const Vertex& aGoal,
-						const wxSize& aRobotSize);
+						const wxSize& aRobotSize,
+						SearchDirection aSearchDirection);
+			/**
+			 * In GridStorage mode a search does not allocate once the buffers of this AStar have grown to the size
+			 * of the world: the SearchGrid, the open set and the connections are reused and the path is written
+			 * into aPath.
+			 */
+			virtual bool searchPath(const wxPoint& aStartPoint,
+									const wxPoint& aGoalPoint,
+									const wxSize& aRobotSize,
+									Path& aPath) override;
+			/**
+			 *
+			 */
+			bool searchPath(Vertex aStart,
+							const Vertex& aGoal,
+							const wxSize& aRobotSize,
+							Path& aPath,
+							SearchDirection aSearchDirection);
+			/**
+			 * The point where the forward and the backward search met in the last search, the goal after
+			 * a Forward search. The actual cost is the cost from the start to the meet point.
+			 */
+			const Vertex& getMeetPoint() const
+			{
+				return meetPoint;
+			}
+			/**
+			 *
+			 * @return the vertices expanded from the start by the last search
+			 */
+			std::size_t getForwardExpansions() const
+			{
+				return forwardExpansions;
+			}
+			/**
+			 *
+			 * @return the vertices expanded from the goal by the last search, 0 after a Forward search
+			 */
+			std::size_t getBackwardExpansions() const
+			{
+				return backwardExpansions;
+			}
 			/**
 			 *
 			 */
@@ -230,11 +208,18 @@ namespace PathAlgorithm
 			/**
 			 *
 			 */
-			void removeFromOpenSet( OpenSet::iterator& i);
+			void removeFromOpenSet( std::size_t aPosition);
 			/**
 			 *
+			 * @return the position of aVertex in the open set, VertexHeap::npos if it is not in the open set
 			 */
-			OpenSet::iterator findInOpenSet( const Vertex& aVertex);
+			std::size_t findInOpenSet( const Vertex& aVertex) const;
+			/**
+			 * Replaces the Vertex at aPosition in the open set with aVertex which must have the same point,
+			 * i.e. the decrease-key operation
+			 */
+			void updateInOpenSet(	std::size_t aPosition,
+									const Vertex& aVertex);
 			/**
 			 *
 			 */
@@ -253,12 +238,10 @@ namespace PathAlgorithm
 			void removeFromClosedSet( const Vertex& aVertex);
 			/**
 			 *
+			 * @return true if aVertex is in the closed set, anActualCost is set to the actual cost it was closed with
 			 */
-			void removeFromClosedSet( ClosedSet::iterator& i);
-			/**
-			 *
-			 */
-			ClosedSet::iterator findInClosedSet( const Vertex& aVertex);
+			bool findInClosedSet(	const Vertex& aVertex,
+									double& anActualCost) const;
 			/**
 			 *
 			 */
@@ -266,17 +249,64 @@ namespace PathAlgorithm
 			/**
 			 *
 			 */
-			ClosedSet getClosedSet() const;
+			virtual ClosedSet getClosedSet() const override;
 			/**
 			 *
 			 */
-			OpenSet getOpenSet() const;
+			virtual OpenSet getOpenSet() const override;
 			/**
 			 *
 			 */
 			VertexMap getPredecessorMap() const;
 
 		protected:
+			/**
+			 * Called by search before the start is opened, by default (re)builds the occupancy grid for aFreeRadius
+			 */
+			virtual void prepareSearch(	const Vertex& aStart,
+										const Vertex& aGoal,
+										int aFreeRadius);
+			/**
+			 * Replaces the contents of aConnections with the outgoing connections of aVertex, by default the
+			 * free 8-connected neighbours. The cost of a connection is the Euclidean distance between its vertices.
+			 */
+			virtual void getConnections(	const Vertex& aVertex,
+											const Vertex& aGoal,
+											std::vector< Edge >& aConnections);
+			/**
+			 * Replaces the contents of aPath with the path from the start to aGoal along the predecessors
+			 */
+			virtual void constructPath(	const Vertex& aGoal,
+											Path& aPath);
+			/**
+			 *
+			 * @return true if getConnections finds a connection from a to b with the same cost whenever it finds
+			 * 			one from b to a, whatever the goal and the predecessors are. Required for a Bidirectional search.
+			 */
+			virtual bool hasReversibleConnections() const
+			{
+				return true;
+			}
+			/**
+			 *
+			 * @return true if aVertex has a predecessor, which is then assigned to aPredecessor
+			 */
+			bool findPredecessor(	const Vertex& aVertex,
+									Vertex& aPredecessor) const;
+			/**
+			 * The walls inflated by the radius of the robot of the current search
+			 */
+			const OccupancyGrid& getOccupancyGrid() const
+			{
+				return occupancyGrid;
+			}
+			/**
+			 * The extent of the walls, the start and the goal of the current search with room to pass around every wall
+			 */
+			const GridExtent& getSearchExtent() const
+			{
+				return searchExtent;
+			}
 			/**
 			 *
 			 */
@@ -288,11 +318,11 @@ namespace PathAlgorithm
 			/**
 			 *
 			 */
-			OpenSet& getOS();
+			VertexHeap& getOS();
 			/**
 			 *
 			 */
-			const OpenSet& getOS() const;
+			const VertexHeap& getOS() const;
 			/**
 			 *
 			 */
@@ -306,15 +336,75 @@ namespace PathAlgorithm
 			/**
 			 *
 			 */
-			ClosedSet closedSet;
+			bool isOutsideGrid( const Vertex& aVertex) const;
+			/**
+			 *
+			 */
+			void setPredecessor(	const Vertex& aVertex,
+									const Vertex& aPredecessor);
+			/**
+			 * The Bidirectional search, the open set and the grid are prepared for the forward search
+			 */
+			bool searchBidirectional(	const Vertex& aStart,
+										const Vertex& aGoal,
+										Path& aPath);
+			/**
+			 * Expands the top of anOpenSet towards aTarget and relaxes its neighbours in aGrid. If a neighbour has
+			 * been reached by the other search the route through it becomes the best one if it is cheaper than aBestCost.
+			 */
+			void expandTowards(	const Vertex& aTarget,
+								VertexHeap& anOpenSet,
+								SearchGrid& aGrid,
+								const SearchGrid& anOtherGrid,
+								double& aBestCost,
+								std::uint32_t& aMeetIndex);
+			/**
+			 *
+			 */
+			StorageMode storageMode;
+			/**
+			 *
+			 */
+			SearchDirection searchDirection;
 			/**
 			 *
 			 */
-			OpenSet openSet;
+			ClosedSet closedSet;
+			/**
+			 * The open set is ordered by cost, the least cost Vertex is on top
+			 */
+			VertexHeap openSet;
 			/**
 			 *
 			 */
 			VertexMap predecessorMap;
+			/**
+			 * Replaces closedSet and predecessorMap in GridStorage mode
+			 */
+			SearchGrid grid;
+			/**
+			 * The walls inflated by the radius of the robot of the last search
+			 */
+			OccupancyGrid occupancyGrid;
+			/**
+			 *
+			 */
+			GridExtent searchExtent;
+			/**
+			 * Reused by every expansion
+			 */
+			std::vector< Edge > connections;
+			/**
+			 * The open set and the grid of the search from the goal in a Bidirectional search
+			 */
+			VertexHeap backwardOpenSet;
+			SearchGrid backwardGrid;
+			/**
+			 *
+			 */
+			Vertex meetPoint;
+			std::size_t forwardExpansions;
+			std::size_t backwardExpansions;
 	}; // class AStar
 } // namespace PathAlgorithm
 #endif // ASTAR_HPP_
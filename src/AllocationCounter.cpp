@@ -0,0 +1,136 @@
+#include "AllocationCounter.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace Base
+{
+	/**
+	 * Every block starts with a header that holds the requested size, so that delete knows how many bytes are freed.
+	 * The header keeps the block aligned for any fundamental type.
+	 */
+	const std::size_t headerSize = alignof( std::max_align_t);
+	/**
+	 *
+	 */
+	std::atomic< std::size_t > allocations( 0);
+	std::atomic< std::size_t > liveBytes( 0);
+	std::atomic< std::size_t > peakBytes( 0);
+	/**
+	 *
+	 */
+	void* CountedAllocate( std::size_t aSize) noexcept
+	{
+		void* block = std::malloc( aSize + headerSize);
+		if (block == nullptr)
+		{
+			return nullptr;
+		}
+		*static_cast< std::size_t* >( block) = aSize;
+
+		allocations.fetch_add( 1, std::memory_order_relaxed);
+		std::size_t live = liveBytes.fetch_add( aSize, std::memory_order_relaxed) + aSize;
+		std::size_t peak = peakBytes.load( std::memory_order_relaxed);
+		while (live > peak && !peakBytes.compare_exchange_weak( peak, live, std::memory_order_relaxed))
+		{
+		}
+		return static_cast< char* >( block) + headerSize;
+	}
+	/**
+	 *
+	 */
+	void CountedFree( void* aPointer) noexcept
+	{
+		if (aPointer == nullptr)
+		{
+			return;
+		}
+		void* block = static_cast< char* >( aPointer) - headerSize;
+		liveBytes.fetch_sub( *static_cast< std::size_t* >( block), std::memory_order_relaxed);
+		std::free( block);
+	}
+	/**
+	 *
+	 */
+	/* static */std::size_t AllocationCounter::getAllocations()
+	{
+		return allocations.load( std::memory_order_relaxed);
+	}
+	/**
+	 *
+	 */
+	/* static */std::size_t AllocationCounter::getLiveBytes()
+	{
+		return liveBytes.load( std::memory_order_relaxed);
+	}
+	/**
+	 *
+	 */
+	/* static */std::size_t AllocationCounter::getPeakBytes()
+	{
+		return peakBytes.load( std::memory_order_relaxed);
+	}
+	/**
+	 *
+	 */
+	/* static */void AllocationCounter::resetPeakBytes()
+	{
+		peakBytes.store( liveBytes.load( std::memory_order_relaxed), std::memory_order_relaxed);
+	}
+} // namespace Base
+
+/**
+ * The replacements of the global allocation functions, the over-aligned variants are not counted
+ */
+void* operator new( std::size_t aSize)
+{
+	void* pointer = Base::CountedAllocate( aSize);
+	if (pointer == nullptr)
+	{
+		throw std::bad_alloc();
+	}
+	return pointer;
+}
+void* operator new[]( std::size_t aSize)
+{
+	return operator new( aSize);
+}
+void* operator new(	std::size_t aSize,
+					const std::nothrow_t&) noexcept
+{
+	return Base::CountedAllocate( aSize);
+}
+void* operator new[](	std::size_t aSize,
+						const std::nothrow_t&) noexcept
+{
+	return Base::CountedAllocate( aSize);
+}
+void operator delete( void* aPointer) noexcept
+{
+	Base::CountedFree( aPointer);
+}
+void operator delete[]( void* aPointer) noexcept
+{
+	Base::CountedFree( aPointer);
+}
+void operator delete(	void* aPointer,
+						std::size_t) noexcept
+{
+	Base::CountedFree( aPointer);
+}
+void operator delete[](	void* aPointer,
+						std::size_t) noexcept
+{
+	Base::CountedFree( aPointer);
+}
+void operator delete(	void* aPointer,
+						const std::nothrow_t&) noexcept
+{
+	Base::CountedFree( aPointer);
+}
+void operator delete[](	void* aPointer,
+						const std::nothrow_t&) noexcept
+{
+	Base::CountedFree( aPointer);
+}
@@ -0,0 +1,41 @@
+#ifndef ALLOCATIONCOUNTER_HPP_
+#define ALLOCATIONCOUNTER_HPP_
+
+#include "Config.hpp"
+
+#include <cstddef>
+
+namespace Base
+{
+	/**
+	 * Counts the calls to the global operator new and the bytes that are allocated through it.
+	 *
+	 * AllocationCounter.cpp replaces the global operator new and delete, so it is only linked into
+	 * robotworld-bench and never into robotworld itself.
+	 */
+	class AllocationCounter
+	{
+		public:
+			/**
+			 *
+			 * @return the number of allocations since the start of the program
+			 */
+			static std::size_t getAllocations();
+			/**
+			 *
+			 * @return the number of bytes that are allocated and not yet deleted
+			 */
+			static std::size_t getLiveBytes();
+			/**
+			 *
+			 * @return the maximum of getLiveBytes() since the last call to resetPeakBytes()
+			 */
+			static std::size_t getPeakBytes();
+			/**
+			 * Sets the peak to the current number of live bytes
+			 */
+			static void resetPeakBytes();
+	};
+	// class AllocationCounter
+} // namespace Base
+#endif // ALLOCATIONCOUNTER_HPP_
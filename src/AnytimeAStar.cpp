@@ -0,0 +1,500 @@
+#include "AnytimeAStar.hpp"
+
+#include "AStar.hpp"
+#include "GridConnectivity.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace PathAlgorithm
+{
+	/**
+	 *
+	 */
+	const double infinity = std::numeric_limits< double >::infinity();
+	/**
+	 *
+	 */
+	const std::uint32_t noSuccessor = std::numeric_limits< std::uint32_t >::max();
+	/**
+	 * Reading the clock is cheap but not free, so the deadline is checked every this many expansions
+	 */
+	const std::size_t clockInterval = 64;
+	/**
+	 *
+	 */
+	AnytimeAStar::AnytimeAStar() :
+					timeBudget( 5000),
+					initialEpsilon( 2.5),
+					epsilonStep( 0.5),
+					epsilon( 2.5),
+					suboptimalityBound( infinity),
+					pass( 0),
+					passPending( false),
+					freeRadius( 0),
+					initialised( false),
+					complete( false)
+	{
+	}
+	/**
+	 *
+	 */
+	void AnytimeAStar::setEpsilon(	double anInitialEpsilon,
+									double anEpsilonStep)
+	{
+		if (anInitialEpsilon < 1.0 || anEpsilonStep <= 0.0)
+		{
+			throw std::invalid_argument( "AnytimeAStar::setEpsilon: the initial epsilon must be at least 1 and the step more than 0");
+		}
+		initialEpsilon = anInitialEpsilon;
+		epsilonStep = anEpsilonStep;
+		initialised = false;
+	}
+	/**
+	 *
+	 */
+	Path AnytimeAStar::search(	const wxPoint& aStartPoint,
+								const wxPoint& aGoalPoint,
+								const wxSize& aRobotSize)
+	{
+		std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+		if (timeBudget > 0)
+		{
+			deadline = std::chrono::steady_clock::now() + std::chrono::microseconds( timeBudget);
+		}
+
+		int radius = getFreeRadius( aRobotSize);
+		expansions = 0;
+		beginProgress();
+
+		WallSnapshotPtr wallSnapshot = getWallSnapshot();
+		bool restart = !initialised || aGoalPoint != goal || radius != freeRadius || !extent.contains( aStartPoint);
+		bool repaired = false;
+		if (!restart)
+		{
+			restart = !updateWalls( *wallSnapshot, repaired);
+		}
+		if (restart)
+		{
+			initialise( aStartPoint, aGoalPoint, radius, *wallSnapshot);
+		} else
+		{
+			if (aStartPoint != start || repaired)
+			{
+				// The keys depend on the start, the distances to the goal do not. The running pass goes on, so the
+				// cells it closed are not expanded again until the next pass
+				start = aStartPoint;
+				suboptimalityBound = infinity;
+				complete = false;
+				if (!passPending)
+				{
+					updateKeys();
+				}
+			}
+			if (passPending)
+			{
+				startPass();
+			}
+		}
+
+		while (!complete && improvePath( deadline))
+		{
+			if (g[extent.index( start.x, start.y)] == infinity)
+			{
+				// Nothing is left to expand
+				complete = true;
+			} else if (epsilon <= 1.0)
+			{
+				suboptimalityBound = 1.0;
+				complete = true;
+			} else
+			{
+				suboptimalityBound = epsilon;
+				epsilon = std::max( 1.0, epsilon - epsilonStep);
+				// Starting a pass calculates every key again, a call that ran out of time leaves that to the next call
+				if (timeBudget > 0 && std::chrono::steady_clock::now() >= deadline)
+				{
+					passPending = true;
+					break;
+				}
+				startPass();
+			}
+		}
+		publishProgress();
+
+		Path path = extractPath();
+		if (path.empty() && complete)
+		{
+			std::cerr << "**** No route from " << aStartPoint << " to " << aGoalPoint << std::endl;
+		}
+		return path;
+	}
+	/**
+	 *
+	 */
+	OpenSet AnytimeAStar::getOpenSet() const
+	{
+		OpenSet openSet;
+		for (const QueueEntry& entry : queue)
+		{
+			Vertex vertex( extent.xOf( entry.cell), extent.yOf( entry.cell));
+			vertex.actualCost = entry.distance;
+			vertex.heuristicCost = entry.key;
+			openSet.push_back( vertex);
+		}
+		return openSet;
+	}
+	/**
+	 *
+	 */
+	ClosedSet AnytimeAStar::getClosedSet() const
+	{
+		ClosedSet closedSet;
+		for (std::uint32_t cell = 0; cell < g.size(); ++cell)
+		{
+			if (g[cell] != infinity)
+			{
+				Vertex vertex( extent.xOf( cell), extent.yOf( cell));
+				vertex.actualCost = g[cell];
+				closedSet.insert( closedSet.end(), vertex);
+			}
+		}
+		return closedSet;
+	}
+	/**
+	 *
+	 */
+	void AnytimeAStar::initialise(	const wxPoint& aStartPoint,
+									const wxPoint& aGoalPoint,
+									int aFreeRadius,
+									const WallSnapshot& aWallSnapshot)
+	{
+		// Another goal needs no new grid, the walls that moved are patched in the grid of the previous search
+		std::vector< std::uint32_t > changedCells;
+		if (!updateGrid( aFreeRadius, aWallSnapshot, changedCells))
+		{
+			occupancyGrid.build( *aWallSnapshot.getClearanceMap( aFreeRadius), aFreeRadius);
+			walls = aWallSnapshot.getWalls();
+		}
+
+		start = aStartPoint;
+		goal = aGoalPoint;
+		freeRadius = aFreeRadius;
+
+		extent = GetSearchExtent( Vertex( start), Vertex( goal), aFreeRadius, aWallSnapshot);
+		g.assign( extent.size(), infinity);
+		successor.assign( extent.size(), noSuccessor);
+		closedInPass.assign( extent.size(), 0);
+		inconsistent.clear();
+		isInconsistent.assign( extent.size(), false);
+		queue.setDenseKeys( extent.size());
+
+		pass = 1;
+		passPending = false;
+		epsilon = initialEpsilon;
+		suboptimalityBound = infinity;
+		complete = false;
+
+		std::uint32_t goalCell = extent.index( goal.x, goal.y);
+		g[goalCell] = 0.0;
+		if (isFree( goal.x, goal.y))
+		{
+			queue.push( calculateKey( goalCell));
+		}
+
+		initialised = true;
+	}
+	/**
+	 *
+	 */
+	bool AnytimeAStar::updateGrid(	int aFreeRadius,
+									const WallSnapshot& aWallSnapshot,
+									std::vector< std::uint32_t >& aChangedCells)
+	{
+		unsigned long wallsVersion = aWallSnapshot.getWallsVersion();
+		if (occupancyGrid.isBuiltFor( aFreeRadius, wallsVersion))
+		{
+			return true;
+		}
+		if (!initialised || occupancyGrid.getFreeRadius() != aFreeRadius)
+		{
+			return false;
+		}
+
+		// The walls are compared by index, a wall that was added or deleted changes the count
+		const std::vector< WallSegment >& currentWalls = aWallSnapshot.getWalls();
+		if (currentWalls.size() != walls.size())
+		{
+			return false;
+		}
+
+		// Everything within the free radius of the old and the new position of a moved wall may have changed
+		GridExtent region;
+		for (std::size_t i = 0; i < walls.size(); ++i)
+		{
+			if (currentWalls[i] != walls[i])
+			{
+				region = region.united( GridExtent::fromCorners( walls[i].first, walls[i].second).inflated( aFreeRadius + 1));
+				region = region.united( GridExtent::fromCorners( currentWalls[i].first, currentWalls[i].second).inflated( aFreeRadius + 1));
+				walls[i] = currentWalls[i];
+			}
+		}
+		if (!occupancyGrid.getExtent().contains( region))
+		{
+			return false;
+		}
+
+		occupancyGrid.update( region, walls, wallsVersion, aChangedCells);
+		return true;
+	}
+	/**
+	 *
+	 */
+	bool AnytimeAStar::updateWalls(	const WallSnapshot& aWallSnapshot,
+									bool& aRepaired)
+	{
+		std::vector< std::uint32_t > changedCells;
+		if (!updateGrid( freeRadius, aWallSnapshot, changedCells))
+		{
+			return false;
+		}
+
+		// The cells whose path to the goal went through a cell that got blocked lose their distance
+		const GridExtent& occupancyExtent = occupancyGrid.getExtent();
+		std::uint32_t goalCell = extent.index( goal.x, goal.y);
+		std::vector< std::uint32_t > lost;
+		std::vector< std::uint32_t > seeds;
+		for (std::uint32_t changedCell : changedCells)
+		{
+			int x = occupancyExtent.xOf( changedCell);
+			int y = occupancyExtent.yOf( changedCell);
+			if (!extent.contains( x, y))
+			{
+				continue;
+			}
+			std::uint32_t cell = extent.index( x, y);
+			if (cell == goalCell)
+			{
+				return false;
+			}
+			aRepaired = true;
+			if (isFree( x, y))
+			{
+				seeds.push_back( cell);
+			} else if (g[cell] != infinity)
+			{
+				g[cell] = infinity;
+				successor[cell] = noSuccessor;
+				closedInPass[cell] = 0;
+				lost.push_back( cell);
+			}
+		}
+		while (!lost.empty())
+		{
+			std::uint32_t cell = lost.back();
+			lost.pop_back();
+
+			int x = extent.xOf( cell);
+			int y = extent.yOf( cell);
+			for (int i = 0; i < EightConnected::moves; ++i)
+			{
+				if (!extent.contains( x + EightConnected::xOffset[i], y + EightConnected::yOffset[i]))
+				{
+					continue;
+				}
+				std::uint32_t predecessor = extent.index( x + EightConnected::xOffset[i], y + EightConnected::yOffset[i]);
+				if (successor[predecessor] == cell)
+				{
+					// A cell without a distance is open again, even if the running pass closed it
+					g[predecessor] = infinity;
+					successor[predecessor] = noSuccessor;
+					closedInPass[predecessor] = 0;
+					lost.push_back( predecessor);
+					seeds.push_back( predecessor);
+				}
+			}
+		}
+
+		// The cells without a distance take the best one of their neighbours that still have one, the expansions
+		// of the next passes spread it further
+		for (std::uint32_t cell : seeds)
+		{
+			int x = extent.xOf( cell);
+			int y = extent.yOf( cell);
+			if (!isFree( x, y))
+			{
+				continue;
+			}
+			for (int i = 0; i < EightConnected::moves; ++i)
+			{
+				if (!isFree( x + EightConnected::xOffset[i], y + EightConnected::yOffset[i]))
+				{
+					continue;
+				}
+				std::uint32_t neighbour = extent.index( x + EightConnected::xOffset[i], y + EightConnected::yOffset[i]);
+				if (g[neighbour] + EightConnected::cost[i] < g[cell])
+				{
+					g[cell] = g[neighbour] + EightConnected::cost[i];
+					successor[cell] = neighbour;
+				}
+			}
+			if (g[cell] != infinity && queue.find( static_cast< std::size_t >( cell)) == Queue::npos)
+			{
+				queue.push( calculateKey( cell));
+			}
+		}
+
+		return true;
+	}
+	/**
+	 *
+	 */
+	void AnytimeAStar::startPass()
+	{
+		++pass;
+		passPending = false;
+
+		for (std::uint32_t cell : inconsistent)
+		{
+			isInconsistent[cell] = false;
+			if (queue.find( static_cast< std::size_t >( cell)) == Queue::npos)
+			{
+				queue.push( calculateKey( cell));
+			}
+		}
+		inconsistent.clear();
+
+		updateKeys();
+	}
+	/**
+	 *
+	 */
+	void AnytimeAStar::updateKeys()
+	{
+		std::vector< std::uint32_t > cells;
+		cells.reserve( queue.size());
+		for (const QueueEntry& entry : queue)
+		{
+			cells.push_back( entry.cell);
+		}
+
+		queue.clear();
+		for (std::uint32_t cell : cells)
+		{
+			queue.push( calculateKey( cell));
+		}
+	}
+	/**
+	 *
+	 */
+	bool AnytimeAStar::improvePath( const std::chrono::steady_clock::time_point& aDeadline)
+	{
+		std::uint32_t startCell = extent.index( start.x, start.y);
+
+		while (!queue.empty() && queue.top().key < g[startCell])
+		{
+			if (isCancelled())
+			{
+				return false;
+			}
+			if (expansions % clockInterval == 0 && std::chrono::steady_clock::now() >= aDeadline)
+			{
+				return false;
+			}
+			++expansions;
+			reportProgress();
+
+			std::uint32_t cell = queue.top().cell;
+			queue.pop();
+			closedInPass[cell] = pass;
+
+			int x = extent.xOf( cell);
+			int y = extent.yOf( cell);
+			for (int i = 0; i < EightConnected::moves; ++i)
+			{
+				if (!isFree( x + EightConnected::xOffset[i], y + EightConnected::yOffset[i]))
+				{
+					continue;
+				}
+				std::uint32_t predecessor = extent.index( x + EightConnected::xOffset[i], y + EightConnected::yOffset[i]);
+				double distance = g[cell] + EightConnected::cost[i];
+				if (distance >= g[predecessor])
+				{
+					continue;
+				}
+				g[predecessor] = distance;
+				successor[predecessor] = cell;
+
+				if (closedInPass[predecessor] != pass)
+				{
+					std::size_t position = queue.find( static_cast< std::size_t >( predecessor));
+					if (position != Queue::npos)
+					{
+						queue.update( position, calculateKey( predecessor));
+					} else
+					{
+						queue.push( calculateKey( predecessor));
+					}
+				} else if (!isInconsistent[predecessor])
+				{
+					// Closed cells are not expanded twice in a pass, the next pass expands it again
+					isInconsistent[predecessor] = true;
+					inconsistent.push_back( predecessor);
+				}
+			}
+		}
+		return true;
+	}
+	/**
+	 *
+	 */
+	Path AnytimeAStar::extractPath() const
+	{
+		std::uint32_t cell = extent.index( start.x, start.y);
+		if (g[cell] == infinity)
+		{
+			return Path();
+		}
+
+		Path path;
+		Vertex current( start);
+		path.push_back( current);
+
+		std::uint32_t goalCell = extent.index( goal.x, goal.y);
+		while (cell != goalCell && path.size() <= extent.size())
+		{
+			cell = successor[cell];
+			Vertex next( extent.xOf( cell), extent.yOf( cell));
+			next.actualCost = current.actualCost + std::sqrt( (next.x - current.x) * (next.x - current.x) + (next.y - current.y) * (next.y - current.y));
+			path.push_back( next);
+			current = next;
+		}
+		return path;
+	}
+	/**
+	 *
+	 */
+	AnytimeAStar::QueueEntry AnytimeAStar::calculateKey( std::uint32_t aCell) const
+	{
+		return QueueEntry{ aCell, g[aCell] + epsilon * heuristic( aCell), g[aCell]};
+	}
+	/**
+	 *
+	 */
+	double AnytimeAStar::heuristic( std::uint32_t aCell) const
+	{
+		double dx = extent.xOf( aCell) - start.x;
+		double dy = extent.yOf( aCell) - start.y;
+		return std::sqrt( dx * dx + dy * dy);
+	}
+	/**
+	 *
+	 */
+	bool AnytimeAStar::isFree(	int anX,
+								int anY) const
+	{
+		return extent.contains( anX, anY) && !occupancyGrid.isBlocked( anX, anY);
+	}
+} // namespace PathAlgorithm
@@ -0,0 +1,274 @@
+#ifndef ANYTIMEASTAR_HPP_
+#define ANYTIMEASTAR_HPP_
+
+#include "Config.hpp"
+
+#include "GridExtent.hpp"
+#include "IndexedHeap.hpp"
+#include "OccupancyGrid.hpp"
+#include "Planner.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+namespace PathAlgorithm
+{
+	/**
+	 * ARA* (Likhachev, Gordon and Thrun, 2003) on the same 8-connected grid as AStar.
+	 *
+	 * A search is a series of weighted A* passes, the first one with the heuristic inflated by the initial epsilon,
+	 * every following one with a smaller epsilon down to 1. The path of a finished pass costs at most epsilon times
+	 * the cost of the shortest path, and a following pass only expands the vertices whose cost improved.
+	 *
+	 * Every call of search stops within the time budget: it returns the best path known so far, which is at least as
+	 * good as the path of the last finished pass, or an empty path if no path is known yet. The first call of a new
+	 * search builds the occupancy grid unless the grid of the previous search can be patched. The build is charged
+	 * against the budget, but on a large world it takes longer than the budget on its own.
+	 *
+	 * As long as the goal and the size of the robot stay the same the next call continues where the previous one
+	 * stopped. The search runs backwards from the goal, so the start may move between the calls. Walls that moved
+	 * (e.g. the walls around another robot) are repaired like DStarLite does: the occupancy grid is patched around
+	 * them, the distances that depended on a cell that got blocked are forgotten and the running pass goes on.
+	 * Anything else (another goal or robot size, walls added or deleted, a start or wall outside
+	 * the grid) starts a new search.
+	 */
+	class AnytimeAStar : public Planner
+	{
+		public:
+			/**
+			 * An initial epsilon of 2.5, steps of 0.5 and a time budget of 5000 microseconds: half a step of the GUI
+			 */
+			AnytimeAStar();
+			/**
+			 *
+			 */
+			virtual Path search(const wxPoint& aStartPoint,
+								const wxPoint& aGoalPoint,
+								const wxSize& aRobotSize) override;
+			/**
+			 * The vertices in the priority queue, the cost is the inflated key of the vertex
+			 */
+			virtual OpenSet getOpenSet() const override;
+			/**
+			 * The vertices with a known distance to the goal
+			 */
+			virtual ClosedSet getClosedSet() const override;
+			/**
+			 * @return true if the next search for the same goal continues to improve the path
+			 */
+			virtual bool isImprovable() const override
+			{
+				return initialised && !complete;
+			}
+			/**
+			 * The wall-clock time one call of search may take, 0 means no limit: the search returns the shortest path
+			 */
+			void setTimeBudget( unsigned long aMicroseconds)
+			{
+				timeBudget = aMicroseconds;
+			}
+			/**
+			 *
+			 */
+			unsigned long getTimeBudget() const
+			{
+				return timeBudget;
+			}
+			/**
+			 *
+			 */
+			virtual std::string getCacheKey() const override
+			{
+				return Planner::getCacheKey() + " " + std::to_string( timeBudget) + " " + std::to_string( initialEpsilon) + " " + std::to_string( epsilonStep);
+			}
+			/**
+			 * The epsilon of the first pass of a new search (at least 1) and the amount it decreases per pass (more than 0)
+			 */
+			void setEpsilon(	double anInitialEpsilon,
+								double anEpsilonStep);
+			/**
+			 * @return the factor by which the path of the last search may be longer than the shortest path,
+			 * 1 for the shortest path and infinity if no pass finished yet for the current start
+			 */
+			double getSuboptimalityBound() const
+			{
+				return suboptimalityBound;
+			}
+
+		private:
+			/**
+			 * An entry in the priority queue: a cell, its inflated key and its distance to the goal
+			 */
+			struct QueueEntry
+			{
+					std::uint32_t cell;
+					double key;
+					double distance;
+			};
+			/**
+			 * Ties go to the entry that is furthest from the goal, which keeps a weighted pass going deep
+			 */
+			struct QueueEntryLessKey
+			{
+					bool operator()(	const QueueEntry& lhs,
+										const QueueEntry& rhs) const
+					{
+						return lhs.key < rhs.key || (lhs.key == rhs.key && lhs.distance > rhs.distance);
+					}
+			};
+			/**
+			 *
+			 */
+			struct QueueEntryCell
+			{
+					std::size_t operator()( const QueueEntry& anEntry) const
+					{
+						return anEntry.cell;
+					}
+			};
+			/**
+			 *
+			 */
+			typedef Base::IndexedHeap< QueueEntry, QueueEntryLessKey, QueueEntryCell > Queue;
+			/**
+			 * Starts a new search for the given walls with the initial epsilon
+			 */
+			void initialise(	const wxPoint& aStartPoint,
+								const wxPoint& aGoalPoint,
+								int aFreeRadius,
+								const WallSnapshot& aWallSnapshot);
+			/**
+			 * Patches the occupancy grid of the previous search around the walls that moved, the indices of the cells
+			 * that changed are appended to aChangedCells
+			 *
+			 * @return false if the grid cannot be patched and must be built again
+			 */
+			bool updateGrid(	int aFreeRadius,
+								const WallSnapshot& aWallSnapshot,
+								std::vector< std::uint32_t >& aChangedCells);
+			/**
+			 * Patches the occupancy grid around the walls that moved. The cells whose path to the goal went through a
+			 * cell that got blocked lose their distance, they and the cells that got free take the best distance of
+			 * their neighbours and go into the queue. aRepaired becomes true if a cell in the extent changed.
+			 *
+			 * @return false if the walls changed in a way that needs a new search
+			 */
+			bool updateWalls(	const WallSnapshot& aWallSnapshot,
+								bool& aRepaired);
+			/**
+			 * Starts a new pass: the inconsistent vertices go back into the queue and every key is calculated
+			 * again for the current epsilon and start
+			 */
+			void startPass();
+			/**
+			 * Calculates every key in the queue again for the current epsilon and start
+			 */
+			void updateKeys();
+			/**
+			 * Expands vertices until the start has the least key
+			 *
+			 * @return false if the time ran out or the search was cancelled first
+			 */
+			bool improvePath( const std::chrono::steady_clock::time_point& aDeadline);
+			/**
+			 * Follows the successors from the start to the goal
+			 */
+			Path extractPath() const;
+			/**
+			 *
+			 */
+			QueueEntry calculateKey( std::uint32_t aCell) const;
+			/**
+			 *
+			 */
+			double heuristic( std::uint32_t aCell) const;
+			/**
+			 * A point can be on the path if it is inside the extent and not blocked
+			 */
+			bool isFree(	int anX,
+							int anY) const;
+			/**
+			 *
+			 */
+			unsigned long timeBudget;
+			/**
+			 *
+			 */
+			double initialEpsilon;
+			/**
+			 *
+			 */
+			double epsilonStep;
+			/**
+			 * The epsilon of the running pass
+			 */
+			double epsilon;
+			/**
+			 *
+			 */
+			double suboptimalityBound;
+			/**
+			 *
+			 */
+			OccupancyGrid occupancyGrid;
+			/**
+			 *
+			 */
+			GridExtent extent;
+			/**
+			 * The distance to the goal per cell
+			 */
+			std::vector< double > g;
+			/**
+			 * The next cell towards the goal per cell
+			 */
+			std::vector< std::uint32_t > successor;
+			/**
+			 * The pass in which a cell was expanded, a cell is closed if it was expanded in the running pass
+			 */
+			std::vector< std::uint32_t > closedInPass;
+			/**
+			 * The closed cells whose distance improved in the running pass, they are expanded again by the next pass
+			 */
+			std::vector< std::uint32_t > inconsistent;
+			std::vector< bool > isInconsistent;
+			/**
+			 *
+			 */
+			Queue queue;
+			/**
+			 *
+			 */
+			std::uint32_t pass;
+			/**
+			 * A pass finished when the time had run out, the next call of search starts the following pass
+			 */
+			bool passPending;
+			/**
+			 *
+			 */
+			wxPoint start;
+			/**
+			 *
+			 */
+			wxPoint goal;
+			/**
+			 *
+			 */
+			int freeRadius;
+			/**
+			 * The walls at the previous search, to find the walls that moved
+			 */
+			std::vector< WallSegment > walls;
+			/**
+			 *
+			 */
+			bool initialised;
+			/**
+			 * The last pass (with an epsilon of 1) finished for the current start, or there is no path at all
+			 */
+			bool complete;
+	}; // class AnytimeAStar
+} // namespace PathAlgorithm
+#endif // ANYTIMEASTAR_HPP_
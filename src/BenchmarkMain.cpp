@@ -0,0 +1,101 @@
+#include "Config.hpp"
+
+#include "CollisionBenchmark.hpp"
+#include "MainApplication.hpp"
+#include "PlannerBenchmark.hpp"
+#include "Trace.hpp"
+
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+// \file
+
+/**
+ * robotworld-bench: runs the path planners without any window and writes the results as JSON lines to stdout.
+ *
+ * -planners=astar,jps,...	the planners to run, by default all planners of PathAlgorithm::CreatePlanner
+ * -runs=N					the number of searches per planner and world, the first one is the cold one
+ * -seed=N					the seed of the first maze
+ * -mazes=N					the number of random mazes
+ * -robots=100,500,...		runs the collision tests for crowds of these numbers of robots instead of the planners
+ *
+ * @see PathAlgorithm::PlannerBenchmark
+ * @see Utils::CollisionBenchmark
+ *
+ * @param argc The number of arguments
+ * @param argv The value of the arguments
+ * @return 0 on success, 1 otherwise
+ */
+int main( 	int argc,
+			char* argv[])
+{
+	// Nothing but results on stdout
+	Base::Trace::enableTrace( false);
+
+	try
+	{
+		Application::MainApplication::setCommandlineArguments( argc, argv);
+
+		if (Application::MainApplication::isArgGiven( "-robots"))
+		{
+			Utils::CollisionBenchmark benchmark;
+			std::vector< unsigned long > robotCounts;
+			std::istringstream is( Application::MainApplication::getArg( "-robots").value);
+			std::string robotCount;
+			while (std::getline( is, robotCount, ','))
+			{
+				robotCounts.push_back( std::stoul( robotCount));
+			}
+			benchmark.setRobotCounts( robotCounts);
+			if (Application::MainApplication::isArgGiven( "-runs"))
+			{
+				benchmark.setRuns( std::stoul( Application::MainApplication::getArg( "-runs").value));
+			}
+			if (Application::MainApplication::isArgGiven( "-seed"))
+			{
+				benchmark.setSeed( std::stoul( Application::MainApplication::getArg( "-seed").value));
+			}
+			benchmark.run( std::cout);
+			return 0;
+		}
+
+		PathAlgorithm::PlannerBenchmark benchmark;
+		if (Application::MainApplication::isArgGiven( "-planners"))
+		{
+			std::vector< std::string > plannerNames;
+			std::istringstream is( Application::MainApplication::getArg( "-planners").value);
+			std::string plannerName;
+			while (std::getline( is, plannerName, ','))
+			{
+				plannerNames.push_back( plannerName);
+			}
+			benchmark.setPlanners( plannerNames);
+		}
+		if (Application::MainApplication::isArgGiven( "-runs"))
+		{
+			benchmark.setRuns( std::stoul( Application::MainApplication::getArg( "-runs").value));
+		}
+		if (Application::MainApplication::isArgGiven( "-seed"))
+		{
+			benchmark.setSeed( std::stoul( Application::MainApplication::getArg( "-seed").value));
+		}
+		if (Application::MainApplication::isArgGiven( "-mazes"))
+		{
+			benchmark.setMazeCount( std::stoul( Application::MainApplication::getArg( "-mazes").value));
+		}
+
+		benchmark.run( std::cout);
+		return 0;
+	}
+	catch (std::exception& e)
+	{
+		std::cerr << __PRETTY_FUNCTION__ << ": " << e.what() << std::endl;
+	}
+	catch (...)
+	{
+		std::cerr << __PRETTY_FUNCTION__ << ": unknown exception" << std::endl;
+	}
+	return 1;
+}
@@ -0,0 +1,135 @@
+#include "ClearanceMap.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace PathAlgorithm
+{
+	/**
+	 * Larger than any squared distance in a map but small enough to add a squared distance to
+	 */
+	const double infinity = 1e20;
+	/**
+	 * The 1D squared Euclidean distance transform of the sampled function f, see
+	 * Felzenszwalb and Huttenlocher, "Distance Transforms of Sampled Functions", 2012.
+	 * The result is the lower envelope of the parabolas (q - p)^2 + f(p).
+	 */
+	void DistanceTransform(	const std::vector< double >& f,
+							std::size_t n,
+							std::vector< double >& d,
+							std::vector< std::size_t >& v,
+							std::vector< double >& z)
+	{
+		std::size_t k = 0;
+		v[0] = 0;
+		z[0] = -infinity;
+		z[1] = infinity;
+		for (std::size_t q = 1; q < n; ++q)
+		{
+			double fq = f[q] + static_cast< double >( q * q);
+			double s = (fq - (f[v[k]] + static_cast< double >( v[k] * v[k]))) / (2.0 * static_cast< double >( q - v[k]));
+			while (s <= z[k])
+			{
+				--k;
+				s = (fq - (f[v[k]] + static_cast< double >( v[k] * v[k]))) / (2.0 * static_cast< double >( q - v[k]));
+			}
+			++k;
+			v[k] = q;
+			z[k] = s;
+			z[k + 1] = infinity;
+		}
+
+		k = 0;
+		for (std::size_t q = 0; q < n; ++q)
+		{
+			while (z[k + 1] < static_cast< double >( q))
+			{
+				++k;
+			}
+			double distance = static_cast< double >( q) - static_cast< double >( v[k]);
+			d[q] = distance * distance + f[v[k]];
+		}
+	}
+
+	/**
+	 *
+	 */
+	void RasteriseWall(	const WallSegment& aWall,
+						std::vector< wxPoint >& somePixels)
+	{
+		const wxPoint& point1 = aWall.first;
+		const wxPoint& point2 = aWall.second;
+		int steps = std::max( std::abs( point2.x - point1.x), std::abs( point2.y - point1.y));
+		for (int step = 0; step <= steps; ++step)
+		{
+			double t = steps == 0 ? 0.0 : static_cast< double >( step) / steps;
+			somePixels.push_back( wxPoint(	static_cast< int >( std::lround( point1.x + t * (point2.x - point1.x))),
+											static_cast< int >( std::lround( point1.y + t * (point2.y - point1.y)))));
+		}
+	}
+	/**
+	 *
+	 */
+	ClearanceMap::ClearanceMap(	const std::vector< WallSegment >& aWalls,
+								int aMargin,
+								unsigned long aWallsVersion) :
+									margin( aMargin),
+									wallsVersion( aWallsVersion)
+	{
+		GridExtent wallsExtent;
+		for (const WallSegment& wall : aWalls)
+		{
+			wallsExtent = wallsExtent.united( wall.first).united( wall.second);
+		}
+		if (wallsExtent.empty())
+		{
+			return;
+		}
+		extent = wallsExtent.inflated( aMargin);
+
+		std::size_t width = static_cast< std::size_t >( extent.width);
+		std::size_t height = static_cast< std::size_t >( extent.height);
+		std::vector< double > grid( extent.size(), infinity);
+
+		std::vector< wxPoint > pixels;
+		for (const WallSegment& wall : aWalls)
+		{
+			RasteriseWall( wall, pixels);
+		}
+		for (const wxPoint& pixel : pixels)
+		{
+			grid[extent.index( pixel.x, pixel.y)] = 0.0;
+		}
+
+		// Separable: first the columns, then the rows
+		std::size_t n = std::max( width, height);
+		std::vector< double > f( n);
+		std::vector< double > d( n);
+		std::vector< std::size_t > v( n);
+		std::vector< double > z( n + 1);
+
+		for (std::size_t x = 0; x < width; ++x)
+		{
+			for (std::size_t y = 0; y < height; ++y)
+			{
+				f[y] = grid[y * width + x];
+			}
+			DistanceTransform( f, height, d, v, z);
+			for (std::size_t y = 0; y < height; ++y)
+			{
+				grid[y * width + x] = d[y];
+			}
+		}
+
+		squaredClearance.resize( extent.size());
+		for (std::size_t y = 0; y < height; ++y)
+		{
+			std::copy( grid.begin() + static_cast< long >( y * width), grid.begin() + static_cast< long >( (y + 1) * width), f.begin());
+			DistanceTransform( f, width, d, v, z);
+			for (std::size_t x = 0; x < width; ++x)
+			{
+				squaredClearance[y * width + x] = static_cast< std::int32_t >( std::min( d[x], static_cast< double >( std::numeric_limits< std::int32_t >::max())));
+			}
+		}
+	}
+} // namespace PathAlgorithm
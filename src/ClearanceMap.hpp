@@ -0,0 +1,121 @@
+#ifndef CLEARANCEMAP_HPP_
+#define CLEARANCEMAP_HPP_
+
+#include "Config.hpp"
+
+#include "GridExtent.hpp"
+#include "Point.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace PathAlgorithm
+{
+	class ClearanceMap;
+	typedef std::shared_ptr< const ClearanceMap > ClearanceMapPtr;
+	/**
+	 * The end points of a wall
+	 */
+	typedef std::pair< wxPoint, wxPoint > WallSegment;
+	/**
+	 * Appends the pixels of aWall to somePixels: every pixel that is within half a pixel of the line (DDA).
+	 * These are the pixels a ClearanceMap measures the distance to.
+	 */
+	void RasteriseWall(	const WallSegment& aWall,
+						std::vector< wxPoint >& somePixels);
+
+	/**
+	 * The Euclidean distance from every point to the nearest wall, computed with a distance
+	 * transform of the rasterised walls. The map does not depend on the size of a robot: a robot
+	 * with a given radius can be at a point if the clearance at that point is at least that radius.
+	 *
+	 * The map covers the extent of the walls plus a margin. Points outside the map have a clearance of at least
+	 * the margin, so the map answers traversability questions correctly for any radius up to the margin.
+	 *
+	 * A ClearanceMap is immutable once built, so a ClearanceMapPtr can be shared between robots and threads.
+	 */
+	class ClearanceMap
+	{
+		public:
+			/**
+			 *
+			 */
+			ClearanceMap(	const std::vector< WallSegment >& aWalls,
+							int aMargin,
+							unsigned long aWallsVersion);
+			/**
+			 *
+			 */
+			unsigned long getWallsVersion() const
+			{
+				return wallsVersion;
+			}
+			/**
+			 *
+			 */
+			int getMargin() const
+			{
+				return margin;
+			}
+			/**
+			 *
+			 */
+			const GridExtent& getExtent() const
+			{
+				return extent;
+			}
+			/**
+			 * @return the squared distance in pixels to the nearest wall, the maximum int for points outside the map
+			 */
+			std::int32_t getSquaredClearance(	int anX,
+												int anY) const
+			{
+				if (!extent.contains( anX, anY))
+				{
+					return std::numeric_limits< std::int32_t >::max();
+				}
+				return squaredClearance[extent.index( anX, anY)];
+			}
+			/**
+			 *
+			 */
+			double getClearance(	int anX,
+									int anY) const
+			{
+				return std::sqrt( static_cast< double >( getSquaredClearance( anX, anY)));
+			}
+			/**
+			 * @return true if a robot with the given radius (at most the margin) does not touch any wall at the given point
+			 */
+			bool isTraversable(	int anX,
+								int anY,
+								int aRadius) const
+			{
+				return getSquaredClearance( anX, anY) >= aRadius * aRadius;
+			}
+
+		private:
+			/**
+			 *
+			 */
+			GridExtent extent;
+			/**
+			 * Squared distances are integers because the walls are rasterised on the pixel grid
+			 */
+			std::vector< std::int32_t > squaredClearance;
+			/**
+			 *
+			 */
+			int margin;
+			/**
+			 *
+			 */
+			unsigned long wallsVersion;
+	};
+	// class ClearanceMap
+} // namespace PathAlgorithm
+#endif // CLEARANCEMAP_HPP_
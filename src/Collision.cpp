@@ -0,0 +1,171 @@
+#include "Collision.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+namespace Utils
+{
+	/**
+	 * Keeps the axis with the least overlap of the intervals [aMin1, aMax1] and [aMin2, aMax2] on the unit axis
+	 * (anAxisX, anAxisY) in aContact, the normal pointing from the first interval to the second one
+	 *
+	 * @return false if the intervals are apart, the axis separates the shapes then
+	 */
+	static bool OverlapOnAxis(	double anAxisX,
+								double anAxisY,
+								double aMin1,
+								double aMax1,
+								double aMin2,
+								double aMax2,
+								Contact& aContact)
+	{
+		double overlap = std::min( aMax1, aMax2) - std::max( aMin1, aMin2);
+		if (overlap < 0.0)
+		{
+			return false;
+		}
+		if (overlap < aContact.depth)
+		{
+			double sign = aMin1 + aMax1 <= aMin2 + aMax2 ? 1.0 : -1.0;
+			aContact.normalX = sign * anAxisX;
+			aContact.normalY = sign * anAxisY;
+			aContact.depth = overlap;
+		}
+		return true;
+	}
+	/**
+	 * Half of the extent of aBox projected on the unit axis
+	 */
+	static double ProjectedRadius(	const OrientedBox& aBox,
+									double anAxisX,
+									double anAxisY)
+	{
+		return aBox.halfLength * std::abs( aBox.axisX * anAxisX + aBox.axisY * anAxisY) +
+				aBox.halfWidth * std::abs( -aBox.axisY * anAxisX + aBox.axisX * anAxisY);
+	}
+	/**
+	 *
+	 */
+	/* static */OrientedBox OrientedBox::fromAngle(	double aCentreX,
+														double aCentreY,
+														double anAngle,
+														double aLength,
+														double aWidth)
+	{
+		return OrientedBox{ aCentreX, aCentreY, std::cos( anAngle), std::sin( anAngle), std::abs( aLength) / 2.0, std::abs( aWidth) / 2.0 };
+	}
+	/**
+	 *
+	 */
+	BoundingBox OrientedBox::getBoundingBox() const
+	{
+		double extentX = halfLength * std::abs( axisX) + halfWidth * std::abs( axisY);
+		double extentY = halfLength * std::abs( axisY) + halfWidth * std::abs( axisX);
+		return BoundingBox{ centreX - extentX, centreY - extentY, centreX + extentX, centreY + extentY };
+	}
+	/**
+	 *
+	 */
+	BoundingBox LineSegment::getBoundingBox() const
+	{
+		return BoundingBox{ std::min( x1, x2), std::min( y1, y2), std::max( x1, x2), std::max( y1, y2) };
+	}
+	/**
+	 *
+	 */
+	bool Collide(	const OrientedBox& aBox1,
+					const OrientedBox& aBox2,
+					Contact& aContact)
+	{
+		const double axes[4][2] = { { aBox1.axisX, aBox1.axisY }, { -aBox1.axisY, aBox1.axisX },
+									{ aBox2.axisX, aBox2.axisY }, { -aBox2.axisY, aBox2.axisX } };
+
+		Contact contact{ 0.0, 0.0, std::numeric_limits< double >::infinity() };
+		for (const double (&axis)[2] : axes)
+		{
+			double centre1 = aBox1.centreX * axis[0] + aBox1.centreY * axis[1];
+			double centre2 = aBox2.centreX * axis[0] + aBox2.centreY * axis[1];
+			double radius1 = ProjectedRadius( aBox1, axis[0], axis[1]);
+			double radius2 = ProjectedRadius( aBox2, axis[0], axis[1]);
+			if (!OverlapOnAxis( axis[0], axis[1], centre1 - radius1, centre1 + radius1, centre2 - radius2, centre2 + radius2, contact))
+			{
+				return false;
+			}
+		}
+		aContact = contact;
+		return true;
+	}
+	/**
+	 *
+	 */
+	bool Collide(	const OrientedBox& aBox,
+					const LineSegment& aSegment,
+					Contact& aContact)
+	{
+		double dx = aSegment.x2 - aSegment.x1;
+		double dy = aSegment.y2 - aSegment.y1;
+		double length = std::hypot( dx, dy);
+
+		// A segment of length 0 is a point, its normal is no axis
+		double axes[3][2] = { { aBox.axisX, aBox.axisY }, { -aBox.axisY, aBox.axisX }, { 0.0, 0.0 } };
+		std::size_t axisCount = 2;
+		if (length > 0.0)
+		{
+			axes[2][0] = -dy / length;
+			axes[2][1] = dx / length;
+			axisCount = 3;
+		}
+
+		Contact contact{ 0.0, 0.0, std::numeric_limits< double >::infinity() };
+		for (std::size_t i = 0; i < axisCount; ++i)
+		{
+			double centre = aBox.centreX * axes[i][0] + aBox.centreY * axes[i][1];
+			double radius = ProjectedRadius( aBox, axes[i][0], axes[i][1]);
+			double end1 = aSegment.x1 * axes[i][0] + aSegment.y1 * axes[i][1];
+			double end2 = aSegment.x2 * axes[i][0] + aSegment.y2 * axes[i][1];
+			if (!OverlapOnAxis( axes[i][0], axes[i][1], centre - radius, centre + radius, std::min( end1, end2), std::max( end1, end2), contact))
+			{
+				return false;
+			}
+		}
+		aContact = contact;
+		return true;
+	}
+	/**
+	 *
+	 */
+	void FindOverlappingPairs(	const std::vector< BoundingBox >& someBoxes,
+								std::vector< std::pair< std::size_t, std::size_t > >& somePairs)
+	{
+		somePairs.clear();
+
+		std::vector< std::size_t > order( someBoxes.size());
+		std::iota( order.begin(), order.end(), 0);
+		std::sort( order.begin(), order.end(), [&someBoxes]( std::size_t lhs, std::size_t rhs)
+		{
+			return someBoxes[lhs].left < someBoxes[rhs].left;
+		});
+
+		// The boxes whose x range still contains the left side of the current box
+		std::vector< std::size_t > active;
+		for (std::size_t current : order)
+		{
+			const BoundingBox& box = someBoxes[current];
+			active.erase( std::remove_if( active.begin(), active.end(), [&someBoxes, &box]( std::size_t other)
+			{
+				return someBoxes[other].right < box.left;
+			}), active.end());
+
+			for (std::size_t other : active)
+			{
+				if (someBoxes[other].top <= box.bottom && box.top <= someBoxes[other].bottom)
+				{
+					somePairs.emplace_back( std::min( current, other), std::max( current, other));
+				}
+			}
+			active.push_back( current);
+		}
+	}
+} // namespace Utils
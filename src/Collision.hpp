@@ -0,0 +1,109 @@
+#ifndef COLLISION_HPP_
+#define COLLISION_HPP_
+
+#include "Config.hpp"
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace Utils
+{
+	/**
+	 * An axis aligned box, the border belongs to the box
+	 */
+	struct BoundingBox
+	{
+			/**
+			 *
+			 */
+			bool overlaps( const BoundingBox& aBox) const
+			{
+				return left <= aBox.right && aBox.left <= right && top <= aBox.bottom && aBox.top <= bottom;
+			}
+
+			double left;
+			double top;
+			double right;
+			double bottom;
+	};
+	// struct BoundingBox
+	/**
+	 * A rectangle that may be rotated: the centre, the unit vector along its length and half of its length and width.
+	 * The width runs along the length axis turned a quarter counter-clockwise, (-axisY, axisX).
+	 */
+	struct OrientedBox
+	{
+			/**
+			 * The box of aLength by aWidth around the centre, its length runs along anAngle (radians)
+			 */
+			static OrientedBox fromAngle(	double aCentreX,
+											double aCentreY,
+											double anAngle,
+											double aLength,
+											double aWidth);
+			/**
+			 *
+			 */
+			BoundingBox getBoundingBox() const;
+
+			double centreX;
+			double centreY;
+			double axisX;
+			double axisY;
+			double halfLength;
+			double halfWidth;
+	};
+	// struct OrientedBox
+	/**
+	 *
+	 */
+	struct LineSegment
+	{
+			/**
+			 *
+			 */
+			BoundingBox getBoundingBox() const;
+
+			double x1;
+			double y1;
+			double x2;
+			double y2;
+	};
+	// struct LineSegment
+	/**
+	 * How two shapes overlap: moving the first shape depth along -normal (or the second one along normal)
+	 * separates them. The normal is a unit vector that points from the first shape to the second.
+	 */
+	struct Contact
+	{
+			double normalX;
+			double normalY;
+			double depth;
+	};
+	// struct Contact
+	/**
+	 * The narrow phase for two robots: the separating axis test over the axes of both boxes. Touching boxes collide with a depth of 0.
+	 *
+	 * @return true if the boxes overlap, aContact is only filled in then
+	 */
+	bool Collide(	const OrientedBox& aBox1,
+					const OrientedBox& aBox2,
+					Contact& aContact);
+	/**
+	 * The narrow phase for a robot and a wall: the separating axis test over the axes of the box and the normal of the segment
+	 *
+	 * @return true if the segment touches or enters the box, aContact is only filled in then
+	 */
+	bool Collide(	const OrientedBox& aBox,
+					const LineSegment& aSegment,
+					Contact& aContact);
+	/**
+	 * The broad phase: replaces the contents of somePairs with the pairs (i, j), i < j, of the boxes that overlap.
+	 * The boxes are swept along x (sort and sweep), so only boxes that overlap in x are compared, which is about
+	 * n log n for robots that are spread out instead of the n * n of comparing every pair.
+	 */
+	void FindOverlappingPairs(	const std::vector< BoundingBox >& someBoxes,
+								std::vector< std::pair< std::size_t, std::size_t > >& somePairs);
+} // namespace Utils
+#endif // COLLISION_HPP_
@@ -0,0 +1,115 @@
+#include "CollisionBenchmark.hpp"
+
+#include "Collision.hpp"
+#include "MathUtils.hpp"
+#include "PlannerBenchmark.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <ostream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+
+namespace Utils
+{
+	/**
+	 * The size of a robot in the benchmark, like the default of PlannerBenchmark
+	 */
+	const double benchmarkRobotLength = 37.0;
+	const double benchmarkRobotWidth = 29.0;
+	/**
+	 * The side of the square every robot gets on average
+	 */
+	const double benchmarkRobotSpacing = 100.0;
+	/**
+	 *
+	 */
+	CollisionBenchmark::CollisionBenchmark() :
+								robotCounts{ 100, 200, 500, 1000 },
+								runs( 10),
+								seed( 1)
+	{
+	}
+	/**
+	 *
+	 */
+	void CollisionBenchmark::run( std::ostream& anOutput)
+	{
+		for (unsigned long robotCount : robotCounts)
+		{
+			std::mt19937 generator( seed);
+			double side = benchmarkRobotSpacing * std::sqrt( static_cast< double >( robotCount));
+			std::uniform_real_distribution< double > coordinate( 0.0, side);
+			std::uniform_real_distribution< double > angle( 0.0, 2.0 * PI);
+
+			std::vector< OrientedBox > robots( robotCount);
+			std::vector< BoundingBox > bounds( robotCount);
+			std::vector< std::pair< std::size_t, std::size_t > > candidates;
+			std::vector< double > allPairsTimes;
+			std::vector< double > broadPhaseTimes;
+			std::size_t collisions = 0;
+
+			for (unsigned long run = 0; run < runs; ++run)
+			{
+				for (OrientedBox& robot : robots)
+				{
+					robot = OrientedBox::fromAngle( coordinate( generator), coordinate( generator), angle( generator), benchmarkRobotLength, benchmarkRobotWidth);
+				}
+
+				Contact contact;
+				std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+				std::size_t allPairsCollisions = 0;
+				for (std::size_t i = 0; i < robots.size(); ++i)
+				{
+					for (std::size_t j = i + 1; j < robots.size(); ++j)
+					{
+						allPairsCollisions += Collide( robots[i], robots[j], contact);
+					}
+				}
+				std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+				allPairsTimes.push_back( std::chrono::duration< double, std::micro >( end - begin).count());
+
+				begin = std::chrono::steady_clock::now();
+				for (std::size_t i = 0; i < robots.size(); ++i)
+				{
+					bounds[i] = robots[i].getBoundingBox();
+				}
+				FindOverlappingPairs( bounds, candidates);
+				collisions = 0;
+				for (const std::pair< std::size_t, std::size_t >& candidate : candidates)
+				{
+					collisions += Collide( robots[candidate.first], robots[candidate.second], contact);
+				}
+				end = std::chrono::steady_clock::now();
+				broadPhaseTimes.push_back( std::chrono::duration< double, std::micro >( end - begin).count());
+
+				if (collisions != allPairsCollisions)
+				{
+					throw std::logic_error( "CollisionBenchmark: the broad phase missed a collision");
+				}
+			}
+			if (allPairsTimes.empty())
+			{
+				continue;
+			}
+			std::sort( allPairsTimes.begin(), allPairsTimes.end());
+			std::sort( broadPhaseTimes.begin(), broadPhaseTimes.end());
+
+			std::ostringstream os;
+			os << std::fixed << std::setprecision( 2);
+			os << "{\"robots\":" << robotCount
+			   << ",\"runs\":" << runs
+			   << ",\"candidate_pairs\":" << candidates.size()
+			   << ",\"collisions\":" << collisions
+			   << ",\"all_pairs_p50_us\":" << PathAlgorithm::Percentile( allPairsTimes, 50.0)
+			   << ",\"all_pairs_max_us\":" << allPairsTimes.back()
+			   << ",\"broad_phase_p50_us\":" << PathAlgorithm::Percentile( broadPhaseTimes, 50.0)
+			   << ",\"broad_phase_max_us\":" << broadPhaseTimes.back()
+			   << "}";
+			anOutput << os.str() << std::endl;
+		}
+	}
+} // namespace Utils
@@ -0,0 +1,71 @@
+#ifndef COLLISIONBENCHMARK_HPP_
+#define COLLISIONBENCHMARK_HPP_
+
+#include "Config.hpp"
+
+#include <iosfwd>
+#include <vector>
+
+namespace Utils
+{
+	/**
+	 * Times the collision tests of a crowd of robots, without any window. Every run puts the robots at random
+	 * positions and angles in a square that gives every robot about 100x100 pixels and finds all colliding pairs
+	 * twice: by testing every pair (Collide on n * (n - 1) / 2 pairs) and by the broad phase (FindOverlappingPairs)
+	 * followed by Collide on the pairs it returns. The result is one JSON object per line for every number of robots:
+	 *
+	 * {"robots":500,"runs":10,"candidate_pairs":150,"collisions":95,
+	 *  "all_pairs_p50_us":1523.40,"all_pairs_max_us":1610.22,"broad_phase_p50_us":61.20,"broad_phase_max_us":70.91}
+	 *
+	 * candidate_pairs and collisions are those of the last run.
+	 */
+	class CollisionBenchmark
+	{
+		public:
+			/**
+			 * 100, 200, 500 and 1000 robots of 37x29, 10 runs, seed 1
+			 */
+			CollisionBenchmark();
+			/**
+			 *
+			 */
+			void setRobotCounts( const std::vector< unsigned long >& someRobotCounts)
+			{
+				robotCounts = someRobotCounts;
+			}
+			/**
+			 *
+			 */
+			void setRuns( unsigned long aRuns)
+			{
+				runs = aRuns;
+			}
+			/**
+			 *
+			 */
+			void setSeed( unsigned long aSeed)
+			{
+				seed = aSeed;
+			}
+			/**
+			 * Writes the results to anOutput, throws if the two ways find different collisions
+			 */
+			void run( std::ostream& anOutput);
+
+		private:
+			/**
+			 *
+			 */
+			std::vector< unsigned long > robotCounts;
+			/**
+			 *
+			 */
+			unsigned long runs;
+			/**
+			 *
+			 */
+			unsigned long seed;
+	};
+	// class CollisionBenchmark
+} // namespace Utils
+#endif // COLLISIONBENCHMARK_HPP_
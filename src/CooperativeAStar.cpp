@@ -0,0 +1,417 @@
+#include "CooperativeAStar.hpp"
+
+#include "AStar.hpp"
+#include "ClearanceMap.hpp"
+#include "GridConnectivity.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <stdexcept>
+
+namespace PathAlgorithm
+{
+	/**
+	 *
+	 */
+	const double infinity = std::numeric_limits< double >::infinity();
+	/**
+	 *
+	 */
+	const std::uint32_t noSuccessor = std::numeric_limits< std::uint32_t >::max();
+	/**
+	 *
+	 */
+	const std::uint32_t noNode = std::numeric_limits< std::uint32_t >::max();
+	/**
+	 * The moves of the space-time search besides the 8 directions
+	 */
+	const std::uint8_t waitMove = 8;
+	const std::uint8_t followMove = 9;
+	/**
+	 * A move of the space-time search takes this many pixels (and moments) at once. A search per pixel would
+	 * spend most of its time on the many equivalent ways to wait a few moments.
+	 */
+	const std::uint32_t moveLength = 8;
+	/**
+	 * A robot that has to wait long in a crowded window makes the space-time search large, it ends at this many states
+	 */
+	const std::size_t maximumNodes = 1 << 18;
+	/**
+	 *
+	 */
+	CooperativeAStar::CooperativeAStar() :
+								window( 128),
+								freeRadius( 0),
+								wallsVersion( 0),
+								initialised( false)
+	{
+	}
+	/**
+	 *
+	 */
+	void CooperativeAStar::setReservationWindow( unsigned long aSteps)
+	{
+		if (aSteps == 0)
+		{
+			throw std::invalid_argument( "CooperativeAStar::setReservationWindow: the window must be at least 1 step");
+		}
+		window = aSteps;
+	}
+	/**
+	 *
+	 */
+	Path CooperativeAStar::search(	const wxPoint& aStartPoint,
+									const wxPoint& aGoalPoint,
+									const wxSize& aRobotSize)
+	{
+		int radius = getFreeRadius( aRobotSize);
+		expansions = 0;
+		beginProgress();
+
+		nodes.clear();
+		nodeIndex.clear();
+		queue.clear();
+
+		WallSnapshotPtr wallSnapshot = getWallSnapshot();
+		if (!initialised || aGoalPoint != goal || radius != freeRadius || wallSnapshot->getWallsVersion() != wallsVersion || !extent.contains( aStartPoint))
+		{
+			initialise( aStartPoint, aGoalPoint, radius, *wallSnapshot);
+		}
+
+		std::uint32_t startCell = extent.index( aStartPoint.x, aStartPoint.y);
+		double startDistance = distanceToGoal( startCell);
+		if (isCancelled())
+		{
+			return Path();
+		}
+		if (startDistance == infinity)
+		{
+			publishProgress();
+			std::cerr << "**** No route from " << aStartPoint << " to " << aGoalPoint << std::endl;
+			return Path();
+		}
+
+		std::uint32_t windowEnd = noNode;
+		const ReservationContext& reservationContext = getReservationContext();
+		if (reservationContext.reservationTable && !reservationContext.reservationTable->empty())
+		{
+			windowEnd = searchWindow( startCell, static_cast< std::uint32_t >( window * std::max( reservationContext.stepLength, 1U)));
+			if (isCancelled())
+			{
+				return Path();
+			}
+		} else
+		{
+			// Nothing to avoid: the path along the distances is the shortest one
+			nodes.push_back( Node{ startCell, 0, 0.0, noNode, waitMove, false});
+			windowEnd = 0;
+		}
+		publishProgress();
+
+		if (windowEnd == noNode)
+		{
+			// Every move, waiting included, runs into another robot: stay here until the path is planned again
+			return Path( 1, Vertex( aStartPoint));
+		}
+		return extractPath( windowEnd);
+	}
+	/**
+	 *
+	 */
+	OpenSet CooperativeAStar::getOpenSet() const
+	{
+		OpenSet openSet;
+		for (const QueueEntry& entry : queue)
+		{
+			Vertex vertex( extent.xOf( nodes[entry.node].cell), extent.yOf( nodes[entry.node].cell));
+			vertex.actualCost = entry.actualCost;
+			vertex.heuristicCost = entry.totalCost;
+			openSet.push_back( vertex);
+		}
+		return openSet;
+	}
+	/**
+	 *
+	 */
+	ClosedSet CooperativeAStar::getClosedSet() const
+	{
+		ClosedSet closedSet;
+		for (const Node& node : nodes)
+		{
+			if (node.expanded)
+			{
+				Vertex vertex( extent.xOf( node.cell), extent.yOf( node.cell));
+				vertex.actualCost = node.actualCost;
+				closedSet.insert( vertex);
+			}
+		}
+		return closedSet;
+	}
+	/**
+	 *
+	 */
+	void CooperativeAStar::initialise(	const wxPoint& aStartPoint,
+										const wxPoint& aGoalPoint,
+										int aFreeRadius,
+										const WallSnapshot& aWallSnapshot)
+	{
+		occupancyGrid.build( *aWallSnapshot.getClearanceMap( aFreeRadius), aFreeRadius);
+
+		origin = aStartPoint;
+		goal = aGoalPoint;
+		freeRadius = aFreeRadius;
+		wallsVersion = aWallSnapshot.getWallsVersion();
+
+		extent = GetSearchExtent( Vertex( aStartPoint), Vertex( aGoalPoint), aFreeRadius, aWallSnapshot);
+		distance.assign( extent.size(), infinity);
+		closed.assign( extent.size(), false);
+		successor.assign( extent.size(), noSuccessor);
+		distanceQueue.setDenseKeys( extent.size());
+
+		if (isFree( goal.x, goal.y))
+		{
+			std::uint32_t goalCell = extent.index( goal.x, goal.y);
+			distance[goalCell] = 0.0;
+			distanceQueue.push( DistanceEntry{ goalCell, 0.0, heuristic( goalCell)});
+		}
+
+		initialised = true;
+	}
+	/**
+	 *
+	 */
+	double CooperativeAStar::distanceToGoal( std::uint32_t aCell)
+	{
+		while (!closed[aCell] && !distanceQueue.empty())
+		{
+			if (isCancelled())
+			{
+				return infinity;
+			}
+			++expansions;
+			reportProgress();
+
+			DistanceEntry entry = distanceQueue.top();
+			distanceQueue.pop();
+			closed[entry.cell] = true;
+
+			int x = extent.xOf( entry.cell);
+			int y = extent.yOf( entry.cell);
+			for (int i = 0; i < EightConnected::moves; ++i)
+			{
+				if (!isFree( x + EightConnected::xOffset[i], y + EightConnected::yOffset[i]))
+				{
+					continue;
+				}
+				std::uint32_t neighbour = extent.index( x + EightConnected::xOffset[i], y + EightConnected::yOffset[i]);
+				double neighbourDistance = entry.distance + EightConnected::cost[i];
+				if (closed[neighbour] || neighbourDistance >= distance[neighbour])
+				{
+					continue;
+				}
+				distance[neighbour] = neighbourDistance;
+				successor[neighbour] = entry.cell;
+
+				DistanceEntry neighbourEntry{ neighbour, neighbourDistance, neighbourDistance + heuristic( neighbour)};
+				std::size_t position = distanceQueue.find( static_cast< std::size_t >( neighbour));
+				if (position != DistanceQueue::npos)
+				{
+					distanceQueue.update( position, neighbourEntry);
+				} else
+				{
+					distanceQueue.push( neighbourEntry);
+				}
+			}
+		}
+		return closed[aCell] ? distance[aCell] : infinity;
+	}
+	/**
+	 *
+	 */
+	std::uint32_t CooperativeAStar::searchWindow(	std::uint32_t aStartCell,
+													std::uint32_t aDepth)
+	{
+		const ReservationContext& reservationContext = getReservationContext();
+		const ReservationTable& reservationTable = *reservationContext.reservationTable;
+		unsigned int stepLength = std::max( reservationContext.stepLength, 1U);
+		std::uint32_t goalCell = extent.index( goal.x, goal.y);
+
+		nodes.push_back( Node{ aStartCell, 0, 0.0, noNode, waitMove, false});
+		queue.push( QueueEntry{ 0, 0.0, distanceToGoal( aStartCell)});
+
+		while (!queue.empty())
+		{
+			if (isCancelled())
+			{
+				return noNode;
+			}
+
+			std::uint32_t current = queue.top().node;
+			queue.pop();
+
+			// The distance beyond the window is exact, so the first state at the end of the window ends the best path
+			Node node = nodes[current];
+			if (node.moment >= aDepth || node.cell == goalCell || nodes.size() >= maximumNodes)
+			{
+				return current;
+			}
+			nodes[current].expanded = true;
+			++expansions;
+			reportProgress();
+
+			for (std::uint8_t move = 0; move <= followMove; ++move)
+			{
+				if (!getMoveCells( node.cell, move, moveCells))
+				{
+					continue;
+				}
+
+				// Every moment of the move must keep clear of the other robots, the robot reaches the cell of a moment
+				// during the step of the RobotWorld that the moment falls in
+				bool reserved = false;
+				for (std::uint32_t i = 0; i < moveCells.size() && !reserved; ++i)
+				{
+					std::uint32_t moment = node.moment + i + 1;
+					unsigned long step = reservationContext.firstStep + (moment + stepLength - 1) / stepLength;
+					reserved = !reservationTable.isFree( wxPoint( extent.xOf( moveCells[i]), extent.yOf( moveCells[i])), freeRadius, step, reservationContext.robot);
+				}
+				if (reserved)
+				{
+					continue;
+				}
+
+				std::uint32_t cell = moveCells.back();
+				double cellDistance = distanceToGoal( cell);
+				if (cellDistance == infinity)
+				{
+					continue;
+				}
+
+				double moveCost = moveLength;
+				if (move < waitMove)
+				{
+					moveCost = moveLength * EightConnected::cost[move];
+				} else if (move == followMove)
+				{
+					moveCost = distance[node.cell] - cellDistance;
+				}
+
+				double actualCost = node.actualCost + moveCost;
+				std::uint32_t moment = node.moment + static_cast< std::uint32_t >( moveCells.size());
+				std::uint64_t key = (static_cast< std::uint64_t >( moment) << 32) | cell;
+				auto found = nodeIndex.find( key);
+				if (found == nodeIndex.end())
+				{
+					std::uint32_t next = static_cast< std::uint32_t >( nodes.size());
+					nodeIndex.emplace( key, next);
+					nodes.push_back( Node{ cell, moment, actualCost, current, move, false});
+					queue.push( QueueEntry{ next, actualCost, actualCost + cellDistance});
+				} else if (!nodes[found->second].expanded && actualCost < nodes[found->second].actualCost)
+				{
+					nodes[found->second].actualCost = actualCost;
+					nodes[found->second].parent = current;
+					nodes[found->second].move = move;
+					queue.update( queue.find( static_cast< std::size_t >( found->second)), QueueEntry{ found->second, actualCost, actualCost + cellDistance});
+				}
+			}
+		}
+		return noNode;
+	}
+	/**
+	 *
+	 */
+	bool CooperativeAStar::getMoveCells(	std::uint32_t aCell,
+											std::uint8_t aMove,
+											std::vector< std::uint32_t >& aCells) const
+	{
+		aCells.clear();
+
+		if (aMove == waitMove)
+		{
+			aCells.assign( moveLength, aCell);
+		} else if (aMove == followMove)
+		{
+			std::uint32_t goalCell = extent.index( goal.x, goal.y);
+			for (std::uint32_t cell = aCell; aCells.size() < moveLength && cell != goalCell && successor[cell] != noSuccessor;)
+			{
+				cell = successor[cell];
+				aCells.push_back( cell);
+			}
+		} else
+		{
+			int x = extent.xOf( aCell);
+			int y = extent.yOf( aCell);
+			for (std::uint32_t i = 0; i < moveLength; ++i)
+			{
+				x += EightConnected::xOffset[aMove];
+				y += EightConnected::yOffset[aMove];
+				if (!isFree( x, y))
+				{
+					return false;
+				}
+				aCells.push_back( extent.index( x, y));
+			}
+		}
+		return !aCells.empty();
+	}
+	/**
+	 *
+	 */
+	Path CooperativeAStar::extractPath( std::uint32_t aNode) const
+	{
+		std::vector< std::uint32_t > windowNodes;
+		for (std::uint32_t node = aNode; node != noNode; node = nodes[node].parent)
+		{
+			windowNodes.push_back( node);
+		}
+		std::reverse( windowNodes.begin(), windowNodes.end());
+
+		// One cell per moment of the window, waiting included
+		std::vector< std::uint32_t > cells( 1, nodes[windowNodes.front()].cell);
+		std::vector< std::uint32_t > cellsOfMove;
+		for (std::size_t i = 1; i < windowNodes.size(); ++i)
+		{
+			getMoveCells( nodes[windowNodes[i - 1]].cell, nodes[windowNodes[i]].move, cellsOfMove);
+			cells.insert( cells.end(), cellsOfMove.begin(), cellsOfMove.end());
+		}
+
+		std::uint32_t goalCell = extent.index( goal.x, goal.y);
+		while (cells.back() != goalCell && successor[cells.back()] != noSuccessor)
+		{
+			cells.push_back( successor[cells.back()]);
+		}
+
+		Path path;
+		path.reserve( cells.size());
+		for (std::uint32_t cell : cells)
+		{
+			Vertex vertex( extent.xOf( cell), extent.yOf( cell));
+			if (!path.empty())
+			{
+				const Vertex& previous = path.back();
+				vertex.actualCost = previous.actualCost + std::sqrt( (vertex.x - previous.x) * (vertex.x - previous.x) + (vertex.y - previous.y) * (vertex.y - previous.y));
+			}
+			path.push_back( vertex);
+		}
+		return path;
+	}
+	/**
+	 * The octile distance to the start of the backward search
+	 */
+	double CooperativeAStar::heuristic( std::uint32_t aCell) const
+	{
+		int dx = std::abs( extent.xOf( aCell) - origin.x);
+		int dy = std::abs( extent.yOf( aCell) - origin.y);
+		return std::max( dx, dy) + (std::sqrt( 2.0) - 1.0) * std::min( dx, dy);
+	}
+	/**
+	 *
+	 */
+	bool CooperativeAStar::isFree(	int anX,
+									int anY) const
+	{
+		return extent.contains( anX, anY) && !occupancyGrid.isBlocked( anX, anY);
+	}
+} // namespace PathAlgorithm
@@ -0,0 +1,264 @@
+#ifndef COOPERATIVEASTAR_HPP_
+#define COOPERATIVEASTAR_HPP_
+
+#include "Config.hpp"
+
+#include "GridExtent.hpp"
+#include "IndexedHeap.hpp"
+#include "OccupancyGrid.hpp"
+#include "Planner.hpp"
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace PathAlgorithm
+{
+	/**
+	 * Windowed hierarchical cooperative A* (WHCA*, Silver 2005) on the same 8-connected grid as AStar.
+	 *
+	 * The first window of the path is searched in space and time: a state is a cell at a moment and a pixel takes one
+	 * moment. A move of the search goes 8 pixels in one of the 8 directions, follows the shortest path for 8 pixels
+	 * or waits 8 moments, and at every moment of it the robot must keep clear of the reservations of the other robots
+	 * (see ReservationTable). A robot moves the step length of the ReservationContext in pixels per step of the
+	 * RobotWorld, so the window of n steps is n times the step length moments deep.
+	 *
+	 * Beyond the window the other robots are ignored: the heuristic is the true distance to the goal around the walls.
+	 * It comes from a reverse resumable A* search (RRA*) from the goal towards the robot, which only runs as far as the
+	 * distances it is asked for and is kept as long as the goal, the size of the robot and the walls stay the same.
+	 * The rest of the path simply follows that distance down to the goal.
+	 *
+	 * The path has one vertex per moment, a waiting robot shows up as the same vertex several times.
+	 */
+	class CooperativeAStar : public Planner
+	{
+		public:
+			/**
+			 * A window of 128 steps
+			 */
+			CooperativeAStar();
+			/**
+			 *
+			 */
+			virtual Path search(const wxPoint& aStartPoint,
+								const wxPoint& aGoalPoint,
+								const wxSize& aRobotSize) override;
+			/**
+			 * The states in the priority queue of the last window
+			 */
+			virtual OpenSet getOpenSet() const override;
+			/**
+			 * The cells that were expanded in the last window
+			 */
+			virtual ClosedSet getClosedSet() const override;
+			/**
+			 *
+			 */
+			virtual unsigned long getReservationWindow() const override
+			{
+				return window;
+			}
+			/**
+			 * @param aSteps the number of steps of the RobotWorld that is searched in space and time, more than 0
+			 */
+			void setReservationWindow( unsigned long aSteps);
+			/**
+			 *
+			 */
+			virtual std::string getCacheKey() const override
+			{
+				return Planner::getCacheKey() + " " + std::to_string( window);
+			}
+
+		private:
+			/**
+			 * A state of the space-time search
+			 */
+			struct Node
+			{
+					std::uint32_t cell;
+					std::uint32_t moment;
+					double actualCost;
+					std::uint32_t parent;
+					std::uint8_t move;
+					bool expanded;
+			};
+			/**
+			 *
+			 */
+			struct QueueEntry
+			{
+					std::uint32_t node;
+					double actualCost;
+					double totalCost;
+			};
+			/**
+			 * Ties go to the entry with the higher actual cost, which is the one that is closer to the goal
+			 */
+			struct QueueEntryLessCost
+			{
+					bool operator()(	const QueueEntry& lhs,
+										const QueueEntry& rhs) const
+					{
+						return lhs.totalCost < rhs.totalCost || (lhs.totalCost == rhs.totalCost && lhs.actualCost > rhs.actualCost);
+					}
+			};
+			/**
+			 *
+			 */
+			struct QueueEntryNode
+			{
+					std::size_t operator()( const QueueEntry& anEntry) const
+					{
+						return anEntry.node;
+					}
+			};
+			/**
+			 *
+			 */
+			typedef Base::IndexedHeap< QueueEntry, QueueEntryLessCost, QueueEntryNode > Queue;
+			/**
+			 * An entry in the queue of the backward search: a cell, its distance to the goal and that distance plus the
+			 * estimated distance to the start of the backward search
+			 */
+			struct DistanceEntry
+			{
+					std::uint32_t cell;
+					double distance;
+					double totalDistance;
+			};
+			/**
+			 *
+			 */
+			struct DistanceEntryLess
+			{
+					bool operator()(	const DistanceEntry& lhs,
+										const DistanceEntry& rhs) const
+					{
+						return lhs.totalDistance < rhs.totalDistance || (lhs.totalDistance == rhs.totalDistance && lhs.distance > rhs.distance);
+					}
+			};
+			/**
+			 *
+			 */
+			struct DistanceEntryCell
+			{
+					std::size_t operator()( const DistanceEntry& anEntry) const
+					{
+						return anEntry.cell;
+					}
+			};
+			/**
+			 *
+			 */
+			typedef Base::IndexedHeap< DistanceEntry, DistanceEntryLess, DistanceEntryCell > DistanceQueue;
+			/**
+			 * Starts a new backward search from aGoalPoint towards aStartPoint
+			 */
+			void initialise(	const wxPoint& aStartPoint,
+								const wxPoint& aGoalPoint,
+								int aFreeRadius,
+								const WallSnapshot& aWallSnapshot);
+			/**
+			 * Resumes the backward search until aCell is closed
+			 *
+			 * @return the true distance of aCell to the goal ignoring the other robots, infinity if there is no path
+			 * or if the search was cancelled
+			 */
+			double distanceToGoal( std::uint32_t aCell);
+			/**
+			 * The space-time search of the window
+			 *
+			 * @return the node in which the window ends, noNode if the robot cannot even wait where it is or the search was cancelled
+			 */
+			std::uint32_t searchWindow(	std::uint32_t aStartCell,
+										std::uint32_t aDepth);
+			/**
+			 * The cells that aMove from aCell passes, one per moment: a straight line in one of the 8 directions,
+			 * waiting where the robot is or following the distances towards the goal
+			 *
+			 * @return false if the move runs into a wall
+			 */
+			bool getMoveCells(	std::uint32_t aCell,
+								std::uint8_t aMove,
+								std::vector< std::uint32_t >& aCells) const;
+			/**
+			 * The space-time path to aNode followed by the path along the distances to the goal, one vertex per moment
+			 */
+			Path extractPath( std::uint32_t aNode) const;
+			/**
+			 *
+			 */
+			double heuristic( std::uint32_t aCell) const;
+			/**
+			 * A point can be on the path if it is inside the extent and not blocked
+			 */
+			bool isFree(	int anX,
+							int anY) const;
+			/**
+			 *
+			 */
+			unsigned long window;
+			/**
+			 *
+			 */
+			OccupancyGrid occupancyGrid;
+			/**
+			 *
+			 */
+			GridExtent extent;
+			/**
+			 * The distance to the goal per cell, only exact for the closed cells
+			 */
+			std::vector< double > distance;
+			/**
+			 * The cells whose distance is final
+			 */
+			std::vector< bool > closed;
+			/**
+			 * The next cell towards the goal per cell
+			 */
+			std::vector< std::uint32_t > successor;
+			/**
+			 *
+			 */
+			DistanceQueue distanceQueue;
+			/**
+			 * The start of the backward search, the point that the heuristic of the backward search aims at
+			 */
+			wxPoint origin;
+			/**
+			 *
+			 */
+			wxPoint goal;
+			/**
+			 *
+			 */
+			int freeRadius;
+			/**
+			 *
+			 */
+			unsigned long wallsVersion;
+			/**
+			 *
+			 */
+			bool initialised;
+			/**
+			 * The states of the space-time search
+			 */
+			std::vector< Node > nodes;
+			/**
+			 * The index in nodes per moment and cell
+			 */
+			std::unordered_map< std::uint64_t, std::uint32_t > nodeIndex;
+			/**
+			 *
+			 */
+			Queue queue;
+			/**
+			 * The cells of the move that is being expanded
+			 */
+			std::vector< std::uint32_t > moveCells;
+	}; // class CooperativeAStar
+} // namespace PathAlgorithm
+#endif // COOPERATIVEASTAR_HPP_
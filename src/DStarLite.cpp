@@ -0,0 +1,367 @@
+#include "DStarLite.hpp"
+
+#include "AStar.hpp"
+#include "ClearanceMap.hpp"
+#include "GridConnectivity.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace PathAlgorithm
+{
+	/**
+	 *
+	 */
+	const double infinity = std::numeric_limits< double >::infinity();
+	/**
+	 *
+	 */
+	DStarLite::DStarLite() :
+					km( 0.0),
+					freeRadius( 0),
+					initialised( false)
+	{
+	}
+	/**
+	 *
+	 */
+	Path DStarLite::search(	const wxPoint& aStartPoint,
+							const wxPoint& aGoalPoint,
+							const wxSize& aRobotSize)
+	{
+		int radius = getFreeRadius( aRobotSize);
+		expansions = 0;
+		beginProgress();
+
+		bool restart = !initialised || aGoalPoint != goal || radius != freeRadius || !extent.contains( aStartPoint);
+		if (!restart)
+		{
+			// The keys in the queue stay valid if km grows with the distance the start moved
+			if (aStartPoint != start)
+			{
+				km += std::sqrt( (aStartPoint.x - start.x) * (aStartPoint.x - start.x) + (aStartPoint.y - start.y) * (aStartPoint.y - start.y));
+				start = aStartPoint;
+			}
+			restart = !updateWalls();
+		}
+		if (restart)
+		{
+			initialise( aStartPoint, aGoalPoint, radius);
+		}
+
+		computeShortestPath();
+		if (isCancelled())
+		{
+			// Every vertex that is not consistent yet is still in the queue, the next search continues from there
+			return Path();
+		}
+		publishProgress();
+
+		Path path = extractPath();
+		if (path.empty())
+		{
+			std::cerr << "**** No route from " << aStartPoint << " to " << aGoalPoint << std::endl;
+		}
+		return path;
+	}
+	/**
+	 *
+	 */
+	OpenSet DStarLite::getOpenSet() const
+	{
+		OpenSet openSet;
+		for (const QueueEntry& entry : queue)
+		{
+			Vertex vertex( extent.xOf( entry.cell), extent.yOf( entry.cell));
+			vertex.actualCost = entry.key2;
+			vertex.heuristicCost = entry.key1;
+			openSet.push_back( vertex);
+		}
+		return openSet;
+	}
+	/**
+	 *
+	 */
+	ClosedSet DStarLite::getClosedSet() const
+	{
+		ClosedSet closedSet;
+		for (std::uint32_t cell = 0; cell < g.size(); ++cell)
+		{
+			if (g[cell] != infinity)
+			{
+				Vertex vertex( extent.xOf( cell), extent.yOf( cell));
+				vertex.actualCost = g[cell];
+				closedSet.insert( closedSet.end(), vertex);
+			}
+		}
+		return closedSet;
+	}
+	/**
+	 *
+	 */
+	void DStarLite::initialise(	const wxPoint& aStartPoint,
+								const wxPoint& aGoalPoint,
+								int aFreeRadius)
+	{
+		WallSnapshotPtr wallSnapshot = getWallSnapshot();
+
+		occupancyGrid.build( *wallSnapshot->getClearanceMap( aFreeRadius), aFreeRadius);
+		walls = wallSnapshot->getWalls();
+
+		start = aStartPoint;
+		goal = aGoalPoint;
+		freeRadius = aFreeRadius;
+		km = 0.0;
+
+		extent = GetSearchExtent( Vertex( start), Vertex( goal), aFreeRadius, *wallSnapshot);
+		g.assign( extent.size(), infinity);
+		rhs.assign( extent.size(), infinity);
+		queue.clear();
+		queue.setDenseKeys( extent.size());
+
+		std::uint32_t goalCell = extent.index( goal.x, goal.y);
+		rhs[goalCell] = 0.0;
+		queue.push( calculateKey( goalCell));
+
+		initialised = true;
+	}
+	/**
+	 *
+	 */
+	bool DStarLite::updateWalls()
+	{
+		WallSnapshotPtr wallSnapshot = getWallSnapshot();
+		unsigned long wallsVersion = wallSnapshot->getWallsVersion();
+		if (occupancyGrid.isBuiltFor( freeRadius, wallsVersion))
+		{
+			return true;
+		}
+
+		// The walls are compared by index, a wall that was added or deleted changes the count
+		const std::vector< WallSegment >& currentWalls = wallSnapshot->getWalls();
+		if (currentWalls.size() != walls.size())
+		{
+			return false;
+		}
+
+		// Everything within the free radius of the old and the new position of a moved wall may have changed
+		GridExtent region;
+		for (std::size_t i = 0; i < walls.size(); ++i)
+		{
+			if (currentWalls[i] != walls[i])
+			{
+				region = region.united( GridExtent::fromCorners( walls[i].first, walls[i].second).inflated( freeRadius + 1));
+				region = region.united( GridExtent::fromCorners( currentWalls[i].first, currentWalls[i].second).inflated( freeRadius + 1));
+				walls[i] = currentWalls[i];
+			}
+		}
+		if (!occupancyGrid.getExtent().contains( region))
+		{
+			return false;
+		}
+
+		std::vector< std::uint32_t > changedCells;
+		occupancyGrid.update( region, walls, wallsVersion, changedCells);
+
+		// Only the cost of the steps into a changed cell changed, so only the vertices around it need an update
+		const GridExtent& occupancyExtent = occupancyGrid.getExtent();
+		std::uint32_t goalCell = extent.index( goal.x, goal.y);
+		for (std::uint32_t changedCell : changedCells)
+		{
+			int x = occupancyExtent.xOf( changedCell);
+			int y = occupancyExtent.yOf( changedCell);
+			for (int i = 0; i < EightConnected::moves; ++i)
+			{
+				if (extent.contains( x + EightConnected::xOffset[i], y + EightConnected::yOffset[i]))
+				{
+					std::uint32_t cell = extent.index( x + EightConnected::xOffset[i], y + EightConnected::yOffset[i]);
+					if (cell != goalCell)
+					{
+						rhs[cell] = calculateRhs( cell);
+						updateVertex( cell);
+					}
+				}
+			}
+		}
+		return true;
+	}
+	/**
+	 *
+	 */
+	void DStarLite::computeShortestPath()
+	{
+		QueueEntryLessKey lessKey;
+		std::uint32_t startCell = extent.index( start.x, start.y);
+		std::uint32_t goalCell = extent.index( goal.x, goal.y);
+
+		while (!queue.empty() && (lessKey( queue.top(), calculateKey( startCell)) || rhs[startCell] > g[startCell]))
+		{
+			if (isCancelled())
+			{
+				return;
+			}
+			++expansions;
+			reportProgress();
+
+			QueueEntry top = queue.top();
+			std::uint32_t cell = top.cell;
+			int x = extent.xOf( cell);
+			int y = extent.yOf( cell);
+
+			QueueEntry newKey = calculateKey( cell);
+			if (lessKey( top, newKey))
+			{
+				queue.update( 0, newKey);
+			} else if (g[cell] > rhs[cell])
+			{
+				// Overconsistent: the distance became shorter, tell the predecessors
+				g[cell] = rhs[cell];
+				queue.pop();
+				if (occupancyGrid.isBlocked( x, y))
+				{
+					continue;
+				}
+				for (int i = 0; i < EightConnected::moves; ++i)
+				{
+					if (extent.contains( x + EightConnected::xOffset[i], y + EightConnected::yOffset[i]))
+					{
+						std::uint32_t predecessor = extent.index( x + EightConnected::xOffset[i], y + EightConnected::yOffset[i]);
+						if (predecessor != goalCell && EightConnected::cost[i] + g[cell] < rhs[predecessor])
+						{
+							rhs[predecessor] = EightConnected::cost[i] + g[cell];
+							updateVertex( predecessor);
+						}
+					}
+				}
+			} else
+			{
+				// Underconsistent: the distance became longer, every predecessor that went via this cell is recalculated
+				double oldG = g[cell];
+				g[cell] = infinity;
+				for (int i = 0; i < EightConnected::moves; ++i)
+				{
+					if (extent.contains( x + EightConnected::xOffset[i], y + EightConnected::yOffset[i]))
+					{
+						std::uint32_t predecessor = extent.index( x + EightConnected::xOffset[i], y + EightConnected::yOffset[i]);
+						if (predecessor != goalCell && rhs[predecessor] == EightConnected::cost[i] + oldG)
+						{
+							rhs[predecessor] = calculateRhs( predecessor);
+						}
+						updateVertex( predecessor);
+					}
+				}
+				if (cell != goalCell)
+				{
+					rhs[cell] = calculateRhs( cell);
+				}
+				updateVertex( cell);
+			}
+		}
+	}
+	/**
+	 *
+	 */
+	Path DStarLite::extractPath() const
+	{
+		std::uint32_t startCell = extent.index( start.x, start.y);
+		if (g[startCell] == infinity && rhs[startCell] == infinity)
+		{
+			return Path();
+		}
+
+		Path path;
+		Vertex current( start);
+		path.push_back( current);
+
+		// Follow the steepest descent of the distance to the goal
+		while (!current.equalPoint( Vertex( goal)) && path.size() <= extent.size())
+		{
+			int best = -1;
+			double bestCost = infinity;
+			for (int i = 0; i < EightConnected::moves; ++i)
+			{
+				int x = current.x + EightConnected::xOffset[i];
+				int y = current.y + EightConnected::yOffset[i];
+				if (isFree( x, y) && EightConnected::cost[i] + g[extent.index( x, y)] < bestCost)
+				{
+					best = i;
+					bestCost = EightConnected::cost[i] + g[extent.index( x, y)];
+				}
+			}
+			if (best < 0)
+			{
+				return Path();
+			}
+
+			Vertex next( current.x + EightConnected::xOffset[best], current.y + EightConnected::yOffset[best]);
+			next.actualCost = current.actualCost + EightConnected::cost[best];
+			path.push_back( next);
+			current = next;
+		}
+		return path;
+	}
+	/**
+	 *
+	 */
+	DStarLite::QueueEntry DStarLite::calculateKey( std::uint32_t aCell) const
+	{
+		double distance = std::min( g[aCell], rhs[aCell]);
+		return QueueEntry{ aCell, distance + heuristic( aCell) + km, distance};
+	}
+	/**
+	 *
+	 */
+	void DStarLite::updateVertex( std::uint32_t aCell)
+	{
+		std::size_t position = queue.find( static_cast< std::size_t >( aCell));
+		if (g[aCell] != rhs[aCell])
+		{
+			if (position != Queue::npos)
+			{
+				queue.update( position, calculateKey( aCell));
+			} else
+			{
+				queue.push( calculateKey( aCell));
+			}
+		} else if (position != Queue::npos)
+		{
+			queue.erase( position);
+		}
+	}
+	/**
+	 *
+	 */
+	double DStarLite::calculateRhs( std::uint32_t aCell) const
+	{
+		int x = extent.xOf( aCell);
+		int y = extent.yOf( aCell);
+
+		double result = infinity;
+		for (int i = 0; i < EightConnected::moves; ++i)
+		{
+			if (isFree( x + EightConnected::xOffset[i], y + EightConnected::yOffset[i]))
+			{
+				result = std::min( result, EightConnected::cost[i] + g[extent.index( x + EightConnected::xOffset[i], y + EightConnected::yOffset[i])]);
+			}
+		}
+		return result;
+	}
+	/**
+	 *
+	 */
+	double DStarLite::heuristic( std::uint32_t aCell) const
+	{
+		double dx = extent.xOf( aCell) - start.x;
+		double dy = extent.yOf( aCell) - start.y;
+		return std::sqrt( dx * dx + dy * dy);
+	}
+	/**
+	 *
+	 */
+	bool DStarLite::isFree(	int anX,
+							int anY) const
+	{
+		return extent.contains( anX, anY) && !occupancyGrid.isBlocked( anX, anY);
+	}
+} // namespace PathAlgorithm
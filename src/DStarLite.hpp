@@ -0,0 +1,171 @@
+#ifndef DSTARLITE_HPP_
+#define DSTARLITE_HPP_
+
+#include "Config.hpp"
+
+#include "GridExtent.hpp"
+#include "IndexedHeap.hpp"
+#include "OccupancyGrid.hpp"
+#include "Planner.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace PathAlgorithm
+{
+	/**
+	 * D* Lite (Koenig and Likhachev, 2002) on the same 8-connected grid as AStar.
+	 *
+	 * The search runs backwards from the goal and is kept between calls of search. As long as the goal and the size
+	 * of the robot stay the same, a following search only repairs the part of the search that is affected by the
+	 * walls that moved since the previous search (e.g. the walls around another robot), and the start may move
+	 * freely. The occupancy grid is patched around the moved walls instead of being derived from a new ClearanceMap.
+	 *
+	 * Anything else (another goal or robot size, walls added or deleted, a start or wall outside the grid)
+	 * starts a new search.
+	 */
+	class DStarLite : public Planner
+	{
+		public:
+			/**
+			 *
+			 */
+			DStarLite();
+			/**
+			 *
+			 */
+			virtual Path search(const wxPoint& aStartPoint,
+								const wxPoint& aGoalPoint,
+								const wxSize& aRobotSize) override;
+			/**
+			 * The vertices in the priority queue, the cost is the key of the vertex
+			 */
+			virtual OpenSet getOpenSet() const override;
+			/**
+			 * The vertices with a known distance to the goal
+			 */
+			virtual ClosedSet getClosedSet() const override;
+
+		private:
+			/**
+			 * An entry in the priority queue: a cell and its two-part key
+			 */
+			struct QueueEntry
+			{
+					std::uint32_t cell;
+					double key1;
+					double key2;
+			};
+			/**
+			 *
+			 */
+			struct QueueEntryLessKey
+			{
+					bool operator()(	const QueueEntry& lhs,
+										const QueueEntry& rhs) const
+					{
+						return lhs.key1 < rhs.key1 || (lhs.key1 == rhs.key1 && lhs.key2 < rhs.key2);
+					}
+			};
+			/**
+			 *
+			 */
+			struct QueueEntryCell
+			{
+					std::size_t operator()( const QueueEntry& anEntry) const
+					{
+						return anEntry.cell;
+					}
+			};
+			/**
+			 *
+			 */
+			typedef Base::IndexedHeap< QueueEntry, QueueEntryLessKey, QueueEntryCell > Queue;
+			/**
+			 * Starts a new search for the current walls
+			 */
+			void initialise(	const wxPoint& aStartPoint,
+								const wxPoint& aGoalPoint,
+								int aFreeRadius);
+			/**
+			 * Patches the occupancy grid around the walls that moved and updates the vertices next to the changed cells
+			 *
+			 * @return false if the walls changed in a way that needs a new search
+			 */
+			bool updateWalls();
+			/**
+			 *
+			 */
+			void computeShortestPath();
+			/**
+			 *
+			 */
+			Path extractPath() const;
+			/**
+			 *
+			 */
+			QueueEntry calculateKey( std::uint32_t aCell) const;
+			/**
+			 *
+			 */
+			void updateVertex( std::uint32_t aCell);
+			/**
+			 * The minimum over the free neighbours of the step cost plus the distance to the goal of that neighbour
+			 */
+			double calculateRhs( std::uint32_t aCell) const;
+			/**
+			 *
+			 */
+			double heuristic( std::uint32_t aCell) const;
+			/**
+			 * A point can be on the path if it is inside the extent and not blocked
+			 */
+			bool isFree(	int anX,
+							int anY) const;
+			/**
+			 *
+			 */
+			OccupancyGrid occupancyGrid;
+			/**
+			 *
+			 */
+			GridExtent extent;
+			/**
+			 * The distance to the goal per cell
+			 */
+			std::vector< double > g;
+			/**
+			 * The one step look-ahead of g per cell
+			 */
+			std::vector< double > rhs;
+			/**
+			 *
+			 */
+			Queue queue;
+			/**
+			 *
+			 */
+			wxPoint start;
+			/**
+			 *
+			 */
+			wxPoint goal;
+			/**
+			 * The sum of the heuristic distances the start has moved, keeps the keys in the queue valid
+			 */
+			double km;
+			/**
+			 *
+			 */
+			int freeRadius;
+			/**
+			 * The walls at the previous search, to find the walls that moved
+			 */
+			std::vector< WallSegment > walls;
+			/**
+			 *
+			 */
+			bool initialised;
+	}; // class DStarLite
+} // namespace PathAlgorithm
+#endif // DSTARLITE_HPP_
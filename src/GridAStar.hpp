@@ -0,0 +1,343 @@
+#ifndef GRIDASTAR_HPP_
+#define GRIDASTAR_HPP_
+
+#include "Config.hpp"
+
+#include "AStar.hpp"
+#include "GridConnectivity.hpp"
+#include "GridExtent.hpp"
+#include "IndexedHeap.hpp"
+#include "OccupancyGrid.hpp"
+#include "Planner.hpp"
+#include "SearchGrid.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+
+namespace PathAlgorithm
+{
+	/**
+	 * @name The heuristics of GridAStar
+	 *
+	 * A heuristic is a class with a static cost( dx, dy) that estimates the cost of the remaining path from the
+	 * absolute differences in x and y to the goal. Only an admissible heuristic (one that never overestimates for
+	 * the connectivity of the search) gives the shortest path.
+	 */
+	//@{
+	/**
+	 * The exact distance on an 8-connected grid without walls, admissible for 4 and 8 connectivity
+	 */
+	struct OctileHeuristic
+	{
+			static double cost(	int dx,
+								int dy)
+			{
+				return std::max( dx, dy) + (diagonalCost - 1.0) * std::min( dx, dy);
+			}
+	};
+	// struct OctileHeuristic
+	/**
+	 * The straight line distance, admissible for every connectivity
+	 */
+	struct EuclideanHeuristic
+	{
+			static double cost(	int dx,
+								int dy)
+			{
+				return std::sqrt( static_cast< double >( dx * dx + dy * dy));
+			}
+	};
+	// struct EuclideanHeuristic
+	/**
+	 * The exact distance on a 4-connected grid without walls, only admissible for 4 connectivity
+	 */
+	struct ManhattanHeuristic
+	{
+			static double cost(	int dx,
+								int dy)
+			{
+				return dx + dy;
+			}
+	};
+	// struct ManhattanHeuristic
+	/**
+	 * BaseHeuristic inflated by Numerator / Denominator (weighted A*): a path costs at most that factor times
+	 * the shortest path if BaseHeuristic is admissible, and the search expands far fewer vertices
+	 */
+	template< typename BaseHeuristic, int Numerator, int Denominator >
+	struct WeightedHeuristic
+	{
+			static double cost(	int dx,
+								int dy)
+			{
+				return BaseHeuristic::cost( dx, dy) * Numerator / Denominator;
+			}
+	};
+	// struct WeightedHeuristic
+	//@}
+
+	/**
+	 * A* on the occupancy grid of the walls, with the heuristic and the connectivity chosen at compile time so that
+	 * the inner loop inlines both: the costs of the moves are constants and only EuclideanHeuristic takes a square root.
+	 *
+	 * Unlike AStar it has no extension points (getConnections and friends) and Vertex only appears at the interface.
+	 * During the search a vertex is the 32-bit index of its cell: a queue entry is the index with float costs
+	 * (12 bytes instead of the 24 of a Vertex) and the state, cost and parent of the cells are stored in a
+	 * CompactSearchGrid. GridAStar< OctileHeuristic, EightConnected > finds paths as short as those of AStar,
+	 * the float costs may differ from the double costs of AStar in the last digits.
+	 * A closed vertex is never opened again: that is exact for a consistent heuristic and keeps the bound of a
+	 * WeightedHeuristic, the other combinations trade the length of the path for fewer expansions.
+	 */
+	template< typename Heuristic, typename Connectivity >
+	class GridAStar : public Planner
+	{
+		public:
+			/**
+			 *
+			 */
+			GridAStar()
+			{
+			}
+			/**
+			 *
+			 */
+			virtual Path search(const wxPoint& aStartPoint,
+								const wxPoint& aGoalPoint,
+								const wxSize& aRobotSize) override
+			{
+				Path path;
+				searchPath( aStartPoint, aGoalPoint, aRobotSize, path);
+				return path;
+			}
+			/**
+			 * The path is written into aPath, a search does not allocate once the buffers have grown to the size of the world
+			 */
+			virtual bool searchPath(const wxPoint& aStartPoint,
+									const wxPoint& aGoalPoint,
+									const wxSize& aRobotSize,
+									Path& aPath) override;
+			/**
+			 *
+			 */
+			virtual OpenSet getOpenSet() const override;
+			/**
+			 *
+			 */
+			virtual ClosedSet getClosedSet() const override;
+
+		private:
+			/**
+			 *
+			 */
+			struct QueueEntry
+			{
+					std::uint32_t cell;
+					float actualCost;
+					float totalCost;
+			};
+			/**
+			 * Ties go to the entry with the higher actual cost, which is the one that is closer to the goal
+			 */
+			struct QueueEntryLessCost
+			{
+					bool operator()(	const QueueEntry& lhs,
+										const QueueEntry& rhs) const
+					{
+						return lhs.totalCost < rhs.totalCost || (lhs.totalCost == rhs.totalCost && lhs.actualCost > rhs.actualCost);
+					}
+			};
+			/**
+			 *
+			 */
+			struct QueueEntryCell
+			{
+					std::size_t operator()( const QueueEntry& anEntry) const
+					{
+						return anEntry.cell;
+					}
+			};
+			/**
+			 *
+			 */
+			typedef Base::IndexedHeap< QueueEntry, QueueEntryLessCost, QueueEntryCell > Queue;
+			/**
+			 *
+			 */
+			float heuristic(	int anX,
+								int anY,
+								const wxPoint& aGoalPoint) const
+			{
+				return static_cast< float >( Heuristic::cost( std::abs( anX - aGoalPoint.x), std::abs( anY - aGoalPoint.y)));
+			}
+			/**
+			 *
+			 */
+			void constructPath(	std::uint32_t aGoalCell,
+								Path& aPath) const;
+			/**
+			 *
+			 */
+			OccupancyGrid occupancyGrid;
+			/**
+			 *
+			 */
+			CompactSearchGrid grid;
+			/**
+			 *
+			 */
+			Queue queue;
+	}; // class GridAStar
+
+	/**
+	 *
+	 */
+	template< typename Heuristic, typename Connectivity >
+	bool GridAStar< Heuristic, Connectivity >::searchPath(	const wxPoint& aStartPoint,
+															const wxPoint& aGoalPoint,
+															const wxSize& aRobotSize,
+															Path& aPath)
+	{
+		aPath.clear();
+		expansions = 0;
+		beginProgress();
+		queue.clear();
+
+		int radius = getFreeRadius( aRobotSize);
+		WallSnapshotPtr wallSnapshot = getWallSnapshot();
+		if (!occupancyGrid.isBuiltFor( radius, wallSnapshot->getWallsVersion()))
+		{
+			occupancyGrid.build( *wallSnapshot->getClearanceMap( radius), radius);
+		}
+
+		const GridExtent extent = GetSearchExtent( Vertex( aStartPoint), Vertex( aGoalPoint), radius, *wallSnapshot);
+		grid.reset( extent);
+		queue.setDenseKeys( extent.size());
+
+		std::uint32_t startCell = extent.index( aStartPoint.x, aStartPoint.y);
+		std::uint32_t goalCell = extent.index( aGoalPoint.x, aGoalPoint.y);
+		grid.setState( startCell, CompactSearchGrid::Open);
+		grid.setActualCost( startCell, 0.0f);
+		grid.setParent( startCell, CompactSearchGrid::noParent);
+		queue.push( QueueEntry{ startCell, 0.0f, heuristic( aStartPoint.x, aStartPoint.y, aGoalPoint)});
+
+		while (!queue.empty())
+		{
+			if (isCancelled())
+			{
+				return false;
+			}
+
+			QueueEntry current = queue.top();
+			if (current.cell == goalCell)
+			{
+				constructPath( goalCell, aPath);
+				publishProgress();
+				return true;
+			}
+			queue.pop();
+			grid.setState( current.cell, CompactSearchGrid::Closed);
+			++expansions;
+			reportProgress();
+
+			int x = extent.xOf( current.cell);
+			int y = extent.yOf( current.cell);
+			for (int move = 0; move < Connectivity::moves; ++move)
+			{
+				int neighbourX = x + Connectivity::xOffset[move];
+				int neighbourY = y + Connectivity::yOffset[move];
+				if (!extent.contains( neighbourX, neighbourY) || !Connectivity::isFree( occupancyGrid, x, y, move))
+				{
+					continue;
+				}
+
+				std::uint32_t neighbour = extent.index( neighbourX, neighbourY);
+				CompactSearchGrid::CellState state = grid.getState( neighbour);
+				float actualCost = current.actualCost + static_cast< float >( Connectivity::cost[move]);
+				if (state == CompactSearchGrid::Closed || (state == CompactSearchGrid::Open && grid.getActualCost( neighbour) <= actualCost))
+				{
+					continue;
+				}
+
+				grid.setActualCost( neighbour, actualCost);
+				grid.setParent( neighbour, current.cell);
+				QueueEntry entry{ neighbour, actualCost, actualCost + heuristic( neighbourX, neighbourY, aGoalPoint)};
+				if (state == CompactSearchGrid::Open)
+				{
+					queue.update( queue.find( neighbour), entry);
+				} else
+				{
+					grid.setState( neighbour, CompactSearchGrid::Open);
+					queue.push( entry);
+				}
+			}
+		}
+
+		publishProgress();
+		std::cerr << "**** No route from " << aStartPoint << " to " << aGoalPoint << std::endl;
+		return false;
+	}
+	/**
+	 *
+	 */
+	template< typename Heuristic, typename Connectivity >
+	OpenSet GridAStar< Heuristic, Connectivity >::getOpenSet() const
+	{
+		OpenSet openSet;
+		const GridExtent& extent = grid.getExtent();
+		for (const QueueEntry& entry : queue)
+		{
+			Vertex vertex( extent.xOf( entry.cell), extent.yOf( entry.cell));
+			vertex.actualCost = entry.actualCost;
+			vertex.heuristicCost = entry.totalCost;
+			openSet.push_back( vertex);
+		}
+		return openSet;
+	}
+	/**
+	 *
+	 */
+	template< typename Heuristic, typename Connectivity >
+	ClosedSet GridAStar< Heuristic, Connectivity >::getClosedSet() const
+	{
+		ClosedSet closedSet;
+		const GridExtent& extent = grid.getExtent();
+		for (std::uint32_t index = 0; index < extent.size(); ++index)
+		{
+			if (grid.isClosed( index))
+			{
+				Vertex vertex( extent.xOf( index), extent.yOf( index));
+				vertex.actualCost = grid.getActualCost( index);
+				closedSet.insert( closedSet.end(), vertex);
+			}
+		}
+		return closedSet;
+	}
+	/**
+	 *
+	 */
+	template< typename Heuristic, typename Connectivity >
+	void GridAStar< Heuristic, Connectivity >::constructPath(	std::uint32_t aGoalCell,
+																Path& aPath) const
+	{
+		const GridExtent& extent = grid.getExtent();
+		std::size_t length = 0;
+		for (std::uint32_t index = aGoalCell; index != CompactSearchGrid::noParent; index = grid.getParent( index))
+		{
+			++length;
+		}
+
+		aPath.assign( length, Vertex( 0, 0));
+		std::size_t position = length;
+		for (std::uint32_t index = aGoalCell; index != CompactSearchGrid::noParent; index = grid.getParent( index))
+		{
+			Vertex& vertex = aPath[--position];
+			vertex.x = extent.xOf( index);
+			vertex.y = extent.yOf( index);
+			vertex.actualCost = grid.getActualCost( index);
+		}
+	}
+} // namespace PathAlgorithm
+#endif // GRIDASTAR_HPP_
@@ -0,0 +1,19 @@
+#include "GridConnectivity.hpp"
+
+namespace PathAlgorithm
+{
+	/**
+	 * The definitions of the tables, needed before C++17 where a static constexpr member that is used as an array is not inline
+	 */
+	constexpr int FourConnected::xOffset[FourConnected::moves];
+	constexpr int FourConnected::yOffset[FourConnected::moves];
+	constexpr double FourConnected::cost[FourConnected::moves];
+
+	constexpr int EightConnected::xOffset[EightConnected::moves];
+	constexpr int EightConnected::yOffset[EightConnected::moves];
+	constexpr double EightConnected::cost[EightConnected::moves];
+
+	constexpr int SixteenConnected::xOffset[SixteenConnected::moves];
+	constexpr int SixteenConnected::yOffset[SixteenConnected::moves];
+	constexpr double SixteenConnected::cost[SixteenConnected::moves];
+} // namespace PathAlgorithm
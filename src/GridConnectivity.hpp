@@ -0,0 +1,101 @@
+#ifndef GRIDCONNECTIVITY_HPP_
+#define GRIDCONNECTIVITY_HPP_
+
+#include "Config.hpp"
+
+#include "OccupancyGrid.hpp"
+
+#include <cstdlib>
+
+namespace PathAlgorithm
+{
+	/**
+	 * The cost of a diagonal move and of a knight move, the square roots of 2 and 5
+	 */
+	constexpr double diagonalCost = 1.4142135623730951;
+	constexpr double knightCost = 2.2360679774997898;
+
+	/**
+	 * @name The connectivities of the grid planners
+	 *
+	 * A connectivity is a class with the number of moves, the x and y offset of every move and its cost, and
+	 * the static isFree that tells whether a move from a free point is possible.
+	 */
+	//@{
+	/**
+	 * The 4 straight neighbours
+	 */
+	struct FourConnected
+	{
+			static constexpr int moves = 4;
+			static constexpr int xOffset[moves] = { 0, 1, 0, -1 };
+			static constexpr int yOffset[moves] = { 1, 0, -1, 0 };
+			static constexpr double cost[moves] = { 1.0, 1.0, 1.0, 1.0 };
+
+			static bool isFree(	const OccupancyGrid& anOccupancyGrid,
+								int anX,
+								int anY,
+								int aMove)
+			{
+				return !anOccupancyGrid.isBlocked( anX + xOffset[aMove], anY + yOffset[aMove]);
+			}
+	};
+	// struct FourConnected
+	/**
+	 * The 8 neighbours, the connectivity of AStar and of the other planners on the grid
+	 */
+	struct EightConnected
+	{
+			static constexpr int moves = 8;
+			static constexpr int xOffset[moves] = { 0, 1, 1, 1, 0, -1, -1, -1 };
+			static constexpr int yOffset[moves] = { 1, 1, 0, -1, -1, -1, 0, 1 };
+			static constexpr double cost[moves] = { 1.0, diagonalCost, 1.0, diagonalCost, 1.0, diagonalCost, 1.0, diagonalCost };
+
+			static bool isFree(	const OccupancyGrid& anOccupancyGrid,
+								int anX,
+								int anY,
+								int aMove)
+			{
+				return !anOccupancyGrid.isBlocked( anX + xOffset[aMove], anY + yOffset[aMove]);
+			}
+	};
+	// struct EightConnected
+	/**
+	 * The 8 neighbours and the 8 knight moves, which gives paths with angles closer to the straight line.
+	 * A knight move also needs the two points it passes between to be free.
+	 */
+	struct SixteenConnected
+	{
+			static constexpr int moves = 16;
+			static constexpr int xOffset[moves] = { 0, 1, 1, 1, 0, -1, -1, -1, 1, 2, 2, 1, -1, -2, -2, -1 };
+			static constexpr int yOffset[moves] = { 1, 1, 0, -1, -1, -1, 0, 1, 2, 1, -1, -2, -2, -1, 1, 2 };
+			static constexpr double cost[moves] = { 1.0, diagonalCost, 1.0, diagonalCost, 1.0, diagonalCost, 1.0, diagonalCost,
+													knightCost, knightCost, knightCost, knightCost, knightCost, knightCost, knightCost, knightCost };
+
+			static bool isFree(	const OccupancyGrid& anOccupancyGrid,
+								int anX,
+								int anY,
+								int aMove)
+			{
+				int dx = xOffset[aMove];
+				int dy = yOffset[aMove];
+				if (anOccupancyGrid.isBlocked( anX + dx, anY + dy))
+				{
+					return false;
+				}
+				if (aMove < 8)
+				{
+					return true;
+				}
+				// The two points halfway along the long side of the move
+				if (std::abs( dy) == 2)
+				{
+					return !anOccupancyGrid.isBlocked( anX, anY + dy / 2) && !anOccupancyGrid.isBlocked( anX + dx, anY + dy / 2);
+				}
+				return !anOccupancyGrid.isBlocked( anX + dx / 2, anY) && !anOccupancyGrid.isBlocked( anX + dx / 2, anY + dy);
+			}
+	};
+	// struct SixteenConnected
+	//@}
+} // namespace PathAlgorithm
+#endif // GRIDCONNECTIVITY_HPP_
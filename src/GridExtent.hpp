@@ -0,0 +1,193 @@
+#ifndef GRIDEXTENT_HPP_
+#define GRIDEXTENT_HPP_
+
+#include "Config.hpp"
+
+#include "Point.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+namespace PathAlgorithm
+{
+	/**
+	 * The rectangle of points that is covered by a grid. Every point in the extent
+	 * has a unique cell index, row by row starting at (left,top).
+	 */
+	struct GridExtent
+	{
+			/**
+			 *
+			 */
+			GridExtent() :
+				left( 0),
+				top( 0),
+				width( 0),
+				height( 0)
+			{
+			}
+			/**
+			 *
+			 */
+			GridExtent(	int aLeft,
+						int aTop,
+						int aWidth,
+						int aHeight) :
+							left( aLeft),
+							top( aTop),
+							width( aWidth),
+							height( aHeight)
+			{
+			}
+			/**
+			 * @return the extent that contains both points
+			 */
+			static GridExtent fromCorners(	const wxPoint& aPoint1,
+											const wxPoint& aPoint2)
+			{
+				int l = std::min( aPoint1.x, aPoint2.x);
+				int t = std::min( aPoint1.y, aPoint2.y);
+				return GridExtent( l, t, std::max( aPoint1.x, aPoint2.x) - l + 1, std::max( aPoint1.y, aPoint2.y) - t + 1);
+			}
+			/**
+			 *
+			 */
+			bool empty() const
+			{
+				return width <= 0 || height <= 0;
+			}
+			/**
+			 *
+			 */
+			std::size_t size() const
+			{
+				return empty() ? 0 : static_cast< std::size_t >( width) * static_cast< std::size_t >( height);
+			}
+			/**
+			 *
+			 */
+			int right() const
+			{
+				return left + width - 1;
+			}
+			/**
+			 *
+			 */
+			int bottom() const
+			{
+				return top + height - 1;
+			}
+			/**
+			 *
+			 */
+			bool contains(	int anX,
+							int anY) const
+			{
+				return anX >= left && anX < left + width && anY >= top && anY < top + height;
+			}
+			/**
+			 *
+			 */
+			bool contains( const wxPoint& aPoint) const
+			{
+				return contains( aPoint.x, aPoint.y);
+			}
+			/**
+			 *
+			 */
+			bool contains( const GridExtent& anExtent) const
+			{
+				return anExtent.empty() || (anExtent.left >= left && anExtent.top >= top && anExtent.right() <= right() && anExtent.bottom() <= bottom());
+			}
+			/**
+			 * The point must be in the extent
+			 */
+			std::uint32_t index(	int anX,
+									int anY) const
+			{
+				return static_cast< std::uint32_t >( (anY - top) * width + (anX - left));
+			}
+			/**
+			 *
+			 */
+			int xOf( std::uint32_t anIndex) const
+			{
+				return left + static_cast< int >( anIndex % static_cast< std::uint32_t >( width));
+			}
+			/**
+			 *
+			 */
+			int yOf( std::uint32_t anIndex) const
+			{
+				return top + static_cast< int >( anIndex / static_cast< std::uint32_t >( width));
+			}
+			/**
+			 * @return the smallest extent that contains this extent and the given point
+			 */
+			GridExtent united( const wxPoint& aPoint) const
+			{
+				if (empty())
+				{
+					return GridExtent( aPoint.x, aPoint.y, 1, 1);
+				}
+				int l = std::min( left, aPoint.x);
+				int t = std::min( top, aPoint.y);
+				return GridExtent( l, t, std::max( right(), aPoint.x) - l + 1, std::max( bottom(), aPoint.y) - t + 1);
+			}
+			/**
+			 * @return the smallest extent that contains both extents
+			 */
+			GridExtent united( const GridExtent& anExtent) const
+			{
+				if (anExtent.empty())
+				{
+					return *this;
+				}
+				return united( wxPoint( anExtent.left, anExtent.top)).united( wxPoint( anExtent.right(), anExtent.bottom()));
+			}
+			/**
+			 * @return the points that are in both extents, an empty extent if there are none
+			 */
+			GridExtent intersected( const GridExtent& anExtent) const
+			{
+				int l = std::max( left, anExtent.left);
+				int t = std::max( top, anExtent.top);
+				int r = std::min( right(), anExtent.right());
+				int b = std::min( bottom(), anExtent.bottom());
+				if (empty() || anExtent.empty() || r < l || b < t)
+				{
+					return GridExtent();
+				}
+				return GridExtent( l, t, r - l + 1, b - t + 1);
+			}
+			/**
+			 * @return the extent grown by aMargin points on every side
+			 */
+			GridExtent inflated( int aMargin) const
+			{
+				return GridExtent( left - aMargin, top - aMargin, width + 2 * aMargin, height + 2 * aMargin);
+			}
+			/**
+			 *
+			 */
+			bool operator==( const GridExtent& anExtent) const
+			{
+				return left == anExtent.left && top == anExtent.top && width == anExtent.width && height == anExtent.height;
+			}
+			/**
+			 *
+			 */
+			bool operator!=( const GridExtent& anExtent) const
+			{
+				return !(*this == anExtent);
+			}
+
+			int left;
+			int top;
+			int width;
+			int height;
+	};
+	// struct GridExtent
+} // namespace PathAlgorithm
+#endif // GRIDEXTENT_HPP_
@@ -0,0 +1,582 @@
+#include "HierarchicalAStar.hpp"
+
+#include "ClearanceMap.hpp"
+#include "GridConnectivity.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <set>
+
+namespace PathAlgorithm
+{
+	/**
+	 *
+	 */
+	const double infinity = std::numeric_limits< double >::infinity();
+	/**
+	 *
+	 */
+	const std::uint32_t noParent = std::numeric_limits< std::uint32_t >::max();
+	/**
+	 * Entrances that are at least this long get a transition at both ends instead of one in the middle
+	 */
+	const int wideEntrance = 6;
+	/**
+	 *
+	 */
+	double Distance(	const wxPoint& aPoint1,
+						const wxPoint& aPoint2)
+	{
+		return std::sqrt( (aPoint1.x - aPoint2.x) * (aPoint1.x - aPoint2.x) + (aPoint1.y - aPoint2.y) * (aPoint1.y - aPoint2.y));
+	}
+	/**
+	 *
+	 */
+	HierarchicalAStar::HierarchicalAStar( int aClusterSize /*= 32*/) :
+								clusterSize( aClusterSize),
+								freeRadius( 0),
+								built( false)
+	{
+	}
+	/**
+	 *
+	 */
+	Path HierarchicalAStar::search(	const wxPoint& aStartPoint,
+									const wxPoint& aGoalPoint,
+									const wxSize& aRobotSize)
+	{
+		openSet.clear();
+		closedSet.clear();
+		expansions = 0;
+		beginProgress();
+
+		int radius = getFreeRadius( aRobotSize);
+
+		WallSnapshotPtr wallSnapshot = getWallSnapshot();
+		bool rebuild = !built || radius != freeRadius || !extent.contains( aStartPoint) || !extent.contains( aGoalPoint);
+		if (!rebuild)
+		{
+			rebuild = !updateWalls( *wallSnapshot);
+		}
+		if (rebuild)
+		{
+			ClearanceMapPtr clearanceMap = wallSnapshot->getClearanceMap( radius);
+			occupancyGrid.build( *clearanceMap, radius);
+			walls = wallSnapshot->getWalls();
+
+			// Keep the extent of the previous graph so the start and goal of earlier searches stay in the graph
+			GridExtent graphExtent = clearanceMap->getExtent().united( GridExtent::fromCorners( aStartPoint, aGoalPoint).inflated( radius + 1));
+			if (built && radius == freeRadius)
+			{
+				graphExtent = graphExtent.united( extent);
+			}
+			build( graphExtent, radius);
+		}
+
+		if (!isFree( aGoalPoint.x, aGoalPoint.y))
+		{
+			std::cerr << "**** No route from " << aStartPoint << " to " << aGoalPoint << std::endl;
+			return Path();
+		}
+
+		// Connect the start and the goal to the nodes of their clusters
+		std::size_t startId = nodes.size();
+		std::size_t goalId = nodes.size() + 1;
+
+		std::vector< double > costs;
+		std::vector< std::uint32_t > parents;
+
+		GridExtent startCluster = getCluster( aStartPoint);
+		GridExtent goalCluster = getCluster( aGoalPoint);
+
+		std::vector< AbstractEdge > startEdges;
+		searchCluster( startCluster, aStartPoint, costs, parents);
+		for (std::size_t node : clusterNodes[std::make_pair( startCluster.left, startCluster.top)])
+		{
+			double cost = costs[startCluster.index( nodes[node].x, nodes[node].y)];
+			if (cost != infinity)
+			{
+				startEdges.push_back( AbstractEdge{ node, cost});
+			}
+		}
+		if (startCluster == goalCluster && costs[startCluster.index( aGoalPoint.x, aGoalPoint.y)] != infinity)
+		{
+			startEdges.push_back( AbstractEdge{ goalId, costs[startCluster.index( aGoalPoint.x, aGoalPoint.y)]});
+		}
+
+		// The goal is free, so the way back from the goal to a node is as long as the way from the node to the goal
+		std::vector< double > costToGoal( nodes.size(), infinity);
+		searchCluster( goalCluster, aGoalPoint, costs, parents);
+		for (std::size_t node : clusterNodes[std::make_pair( goalCluster.left, goalCluster.top)])
+		{
+			costToGoal[node] = costs[goalCluster.index( nodes[node].x, nodes[node].y)];
+		}
+
+		// The abstract search
+		std::vector< wxPoint > points( nodes);
+		points.push_back( aStartPoint);
+		points.push_back( aGoalPoint);
+
+		std::vector< double > actualCosts( points.size(), infinity);
+		std::vector< std::size_t > predecessors( points.size(), startId);
+		std::vector< bool > closed( points.size(), false);
+
+		Queue queue;
+		queue.setDenseKeys( points.size());
+		actualCosts[startId] = 0.0;
+		queue.push( QueueEntry{ static_cast< std::uint32_t >( startId), Distance( aStartPoint, aGoalPoint), 0.0});
+
+		while (!queue.empty() && !closed[goalId])
+		{
+			if (isCancelled())
+			{
+				return Path();
+			}
+			std::size_t current = queue.top().id;
+			queue.pop();
+			closed[current] = true;
+			++expansions;
+			reportProgress();
+
+			std::vector< AbstractEdge > connections;
+			if (current == startId)
+			{
+				connections = startEdges;
+			} else if (current != goalId)
+			{
+				connections = edges[current];
+				if (costToGoal[current] != infinity)
+				{
+					connections.push_back( AbstractEdge{ goalId, costToGoal[current]});
+				}
+			}
+
+			for (const AbstractEdge& edge : connections)
+			{
+				double actualCost = actualCosts[current] + edge.cost;
+				if (closed[edge.to] || actualCost >= actualCosts[edge.to])
+				{
+					continue;
+				}
+				actualCosts[edge.to] = actualCost;
+				predecessors[edge.to] = current;
+
+				QueueEntry entry{ static_cast< std::uint32_t >( edge.to), actualCost + Distance( points[edge.to], aGoalPoint), actualCost};
+				std::size_t position = queue.find( entry);
+				if (position != Queue::npos)
+				{
+					queue.update( position, entry);
+				} else
+				{
+					queue.push( entry);
+				}
+			}
+		}
+
+		for (const QueueEntry& entry : queue)
+		{
+			Vertex vertex( points[entry.id]);
+			vertex.actualCost = entry.cost;
+			vertex.heuristicCost = entry.key;
+			openSet.push_back( vertex);
+		}
+		for (std::size_t id = 0; id < points.size(); ++id)
+		{
+			if (closed[id])
+			{
+				Vertex vertex( points[id]);
+				vertex.actualCost = actualCosts[id];
+				closedSet.insert( vertex);
+			}
+		}
+		publishProgress();
+
+		if (!closed[goalId])
+		{
+			std::cerr << "**** No route from " << aStartPoint << " to " << aGoalPoint << std::endl;
+			return Path();
+		}
+
+		// Refine the abstract path into pixels
+		std::vector< std::size_t > abstractPath;
+		for (std::size_t id = goalId; id != startId; id = predecessors[id])
+		{
+			abstractPath.push_back( id);
+		}
+		abstractPath.push_back( startId);
+		std::reverse( abstractPath.begin(), abstractPath.end());
+
+		Path path;
+		path.push_back( Vertex( aStartPoint));
+		for (std::size_t i = 1; i < abstractPath.size(); ++i)
+		{
+			const wxPoint& from = points[abstractPath[i - 1]];
+			const wxPoint& to = points[abstractPath[i]];
+
+			GridExtent cluster = getCluster( from);
+			Path segment;
+			if (cluster.contains( to))
+			{
+				segment = refine( from, to, cluster);
+			} else
+			{
+				// A transition to the neighbouring cluster
+				segment.push_back( Vertex( to));
+			}
+
+			for (Vertex& vertex : segment)
+			{
+				const Vertex& previous = path.back();
+				bool diagonal = vertex.x != previous.x && vertex.y != previous.y;
+				vertex.actualCost = previous.actualCost + (diagonal ? std::sqrt( 2.0) : 1.0);
+				path.push_back( vertex);
+			}
+		}
+		return path;
+	}
+	/**
+	 *
+	 */
+	OpenSet HierarchicalAStar::getOpenSet() const
+	{
+		return openSet;
+	}
+	/**
+	 *
+	 */
+	ClosedSet HierarchicalAStar::getClosedSet() const
+	{
+		return closedSet;
+	}
+	/**
+	 *
+	 */
+	void HierarchicalAStar::build(	const GridExtent& anExtent,
+									int aFreeRadius)
+	{
+		extent = anExtent;
+		freeRadius = aFreeRadius;
+
+		transitions.clear();
+		clusterGraphs.clear();
+		for (int top = extent.top; top <= extent.bottom(); top += clusterSize)
+		{
+			for (int left = extent.left; left <= extent.right(); left += clusterSize)
+			{
+				addTransitions( getCluster( wxPoint( left, top)));
+			}
+		}
+		connect();
+
+		built = true;
+	}
+	/**
+	 *
+	 */
+	bool HierarchicalAStar::updateWalls( const WallSnapshot& aWallSnapshot)
+	{
+		unsigned long wallsVersion = aWallSnapshot.getWallsVersion();
+		if (occupancyGrid.isBuiltFor( freeRadius, wallsVersion))
+		{
+			return true;
+		}
+
+		// The walls are compared by index, a wall that was added or deleted changes the count
+		const std::vector< WallSegment >& currentWalls = aWallSnapshot.getWalls();
+		if (currentWalls.size() != walls.size())
+		{
+			return false;
+		}
+
+		// Everything within the free radius of the old and the new position of a moved wall may have changed
+		GridExtent region;
+		for (std::size_t i = 0; i < walls.size(); ++i)
+		{
+			if (currentWalls[i] != walls[i])
+			{
+				region = region.united( GridExtent::fromCorners( walls[i].first, walls[i].second).inflated( freeRadius + 1));
+				region = region.united( GridExtent::fromCorners( currentWalls[i].first, currentWalls[i].second).inflated( freeRadius + 1));
+				walls[i] = currentWalls[i];
+			}
+		}
+		if (!occupancyGrid.getExtent().contains( region))
+		{
+			return false;
+		}
+
+		std::vector< std::uint32_t > changedCells;
+		occupancyGrid.update( region, walls, wallsVersion, changedCells);
+
+		std::set< std::pair< int, int > > changedClusters;
+		const GridExtent& occupancyExtent = occupancyGrid.getExtent();
+		for (std::uint32_t changedCell : changedCells)
+		{
+			wxPoint point( occupancyExtent.xOf( changedCell), occupancyExtent.yOf( changedCell));
+			if (extent.contains( point))
+			{
+				GridExtent cluster = getCluster( point);
+				changedClusters.insert( std::make_pair( cluster.left, cluster.top));
+			}
+		}
+		if (changedClusters.empty())
+		{
+			return true;
+		}
+
+		// A changed cluster owns its right and bottom border, the left and the top border belong to its neighbours
+		for (const std::pair< int, int >& changedCluster : changedClusters)
+		{
+			GridExtent cluster = getCluster( wxPoint( changedCluster.first, changedCluster.second));
+			addTransitions( cluster);
+			if (cluster.left > extent.left)
+			{
+				addTransitions( getCluster( wxPoint( cluster.left - 1, cluster.top)));
+			}
+			if (cluster.top > extent.top)
+			{
+				addTransitions( getCluster( wxPoint( cluster.left, cluster.top - 1)));
+			}
+			clusterGraphs.erase( changedCluster);
+		}
+		connect();
+		return true;
+	}
+	/**
+	 *
+	 */
+	void HierarchicalAStar::addTransitions( const GridExtent& aCluster)
+	{
+		std::vector< Transition >& clusterTransitions = transitions[std::make_pair( aCluster.left, aCluster.top)];
+		clusterTransitions.clear();
+		if (aCluster.right() < extent.right())
+		{
+			addEntrances( wxPoint( aCluster.right(), aCluster.top), aCluster.height, wxPoint( 0, 1), wxPoint( 1, 0), clusterTransitions);
+		}
+		if (aCluster.bottom() < extent.bottom())
+		{
+			addEntrances( wxPoint( aCluster.left, aCluster.bottom()), aCluster.width, wxPoint( 1, 0), wxPoint( 0, 1), clusterTransitions);
+		}
+	}
+	/**
+	 *
+	 */
+	void HierarchicalAStar::addEntrances(	const wxPoint& aFirst,
+											int aLength,
+											const wxPoint& aDirection,
+											const wxPoint& anAcross,
+											std::vector< Transition >& aTransitions) const
+	{
+		int runStart = -1;
+		for (int i = 0; i <= aLength; ++i)
+		{
+			wxPoint point( aFirst.x + i * aDirection.x, aFirst.y + i * aDirection.y);
+			bool open = i < aLength && isFree( point.x, point.y) && isFree( point.x + anAcross.x, point.y + anAcross.y);
+			if (open && runStart < 0)
+			{
+				runStart = i;
+			} else if (!open && runStart >= 0)
+			{
+				int runEnd = i - 1;
+				std::vector< int > runTransitions;
+				if (runEnd - runStart + 1 < wideEntrance)
+				{
+					runTransitions.push_back( (runStart + runEnd) / 2);
+				} else
+				{
+					runTransitions.push_back( runStart);
+					runTransitions.push_back( runEnd);
+				}
+				for (int transition : runTransitions)
+				{
+					wxPoint inside( aFirst.x + transition * aDirection.x, aFirst.y + transition * aDirection.y);
+					aTransitions.push_back( Transition{ inside, wxPoint( inside.x + anAcross.x, inside.y + anAcross.y)});
+				}
+				runStart = -1;
+			}
+		}
+	}
+	/**
+	 *
+	 */
+	void HierarchicalAStar::connect()
+	{
+		nodes.clear();
+		nodeAtCell.clear();
+		edges.clear();
+		clusterNodes.clear();
+
+		for (int top = extent.top; top <= extent.bottom(); top += clusterSize)
+		{
+			for (int left = extent.left; left <= extent.right(); left += clusterSize)
+			{
+				for (const Transition& transition : transitions[std::make_pair( left, top)])
+				{
+					std::size_t insideNode = addNode( transition.inside);
+					std::size_t outsideNode = addNode( transition.outside);
+					edges[insideNode].push_back( AbstractEdge{ outsideNode, 1.0});
+					edges[outsideNode].push_back( AbstractEdge{ insideNode, 1.0});
+				}
+			}
+		}
+		addIntraEdges();
+	}
+	/**
+	 *
+	 */
+	std::size_t HierarchicalAStar::addNode( const wxPoint& aPoint)
+	{
+		std::uint32_t cell = extent.index( aPoint.x, aPoint.y);
+		std::map< std::uint32_t, std::size_t >::iterator i = nodeAtCell.find( cell);
+		if (i != nodeAtCell.end())
+		{
+			return (*i).second;
+		}
+
+		std::size_t node = nodes.size();
+		nodes.push_back( aPoint);
+		edges.push_back( std::vector< AbstractEdge >());
+		nodeAtCell.insert( std::make_pair( cell, node));
+
+		GridExtent cluster = getCluster( aPoint);
+		clusterNodes[std::make_pair( cluster.left, cluster.top)].push_back( node);
+		return node;
+	}
+	/**
+	 *
+	 */
+	void HierarchicalAStar::addIntraEdges()
+	{
+		std::vector< double > costs;
+		std::vector< std::uint32_t > parents;
+
+		for (const std::pair< const std::pair< int, int >, std::vector< std::size_t > >& clusterNode : clusterNodes)
+		{
+			const std::vector< std::size_t >& clusterNodeIds = clusterNode.second;
+			GridExtent cluster = getCluster( wxPoint( clusterNode.first.first, clusterNode.first.second));
+
+			std::vector< wxPoint > clusterPoints;
+			for (std::size_t node : clusterNodeIds)
+			{
+				clusterPoints.push_back( nodes[node]);
+			}
+
+			ClusterGraph& clusterGraph = clusterGraphs[clusterNode.first];
+			if (clusterGraph.nodes != clusterPoints)
+			{
+				clusterGraph.nodes = clusterPoints;
+				clusterGraph.edges.clear();
+
+				// All nodes are free so the costs are symmetric, one search per pair is enough
+				for (std::size_t i = 0; i + 1 < clusterPoints.size(); ++i)
+				{
+					searchCluster( cluster, clusterPoints[i], costs, parents);
+					for (std::size_t j = i + 1; j < clusterPoints.size(); ++j)
+					{
+						double cost = costs[cluster.index( clusterPoints[j].x, clusterPoints[j].y)];
+						if (cost != infinity)
+						{
+							clusterGraph.edges.push_back( IntraEdge{ i, j, cost});
+						}
+					}
+				}
+			}
+
+			for (const IntraEdge& edge : clusterGraph.edges)
+			{
+				edges[clusterNodeIds[edge.from]].push_back( AbstractEdge{ clusterNodeIds[edge.to], edge.cost});
+				edges[clusterNodeIds[edge.to]].push_back( AbstractEdge{ clusterNodeIds[edge.from], edge.cost});
+			}
+		}
+	}
+	/**
+	 *
+	 */
+	GridExtent HierarchicalAStar::getCluster( const wxPoint& aPoint) const
+	{
+		int left = extent.left + ((aPoint.x - extent.left) / clusterSize) * clusterSize;
+		int top = extent.top + ((aPoint.y - extent.top) / clusterSize) * clusterSize;
+		return GridExtent( left, top, std::min( clusterSize, extent.right() - left + 1), std::min( clusterSize, extent.bottom() - top + 1));
+	}
+	/**
+	 *
+	 */
+	void HierarchicalAStar::searchCluster(	const GridExtent& aCluster,
+											const wxPoint& aSource,
+											std::vector< double >& aCosts,
+											std::vector< std::uint32_t >& aParents) const
+	{
+		aCosts.assign( aCluster.size(), infinity);
+		aParents.assign( aCluster.size(), noParent);
+
+		Queue queue;
+		queue.setDenseKeys( aCluster.size());
+
+		std::uint32_t source = aCluster.index( aSource.x, aSource.y);
+		aCosts[source] = 0.0;
+		queue.push( QueueEntry{ source, 0.0, 0.0});
+
+		while (!queue.empty())
+		{
+			std::uint32_t current = queue.top().id;
+			queue.pop();
+
+			int x = aCluster.xOf( current);
+			int y = aCluster.yOf( current);
+			for (int i = 0; i < EightConnected::moves; ++i)
+			{
+				int nx = x + EightConnected::xOffset[i];
+				int ny = y + EightConnected::yOffset[i];
+				if (!aCluster.contains( nx, ny) || !isFree( nx, ny))
+				{
+					continue;
+				}
+				std::uint32_t neighbour = aCluster.index( nx, ny);
+				double cost = aCosts[current] + EightConnected::cost[i];
+				if (cost < aCosts[neighbour])
+				{
+					aCosts[neighbour] = cost;
+					aParents[neighbour] = current;
+
+					QueueEntry entry{ neighbour, cost, cost};
+					std::size_t position = queue.find( entry);
+					if (position != Queue::npos)
+					{
+						queue.update( position, entry);
+					} else
+					{
+						queue.push( entry);
+					}
+				}
+			}
+		}
+	}
+	/**
+	 *
+	 */
+	Path HierarchicalAStar::refine(	const wxPoint& aFrom,
+									const wxPoint& aTo,
+									const GridExtent& aCluster) const
+	{
+		std::vector< double > costs;
+		std::vector< std::uint32_t > parents;
+		searchCluster( aCluster, aFrom, costs, parents);
+
+		Path path;
+		std::uint32_t source = aCluster.index( aFrom.x, aFrom.y);
+		for (std::uint32_t cell = aCluster.index( aTo.x, aTo.y); cell != source && cell != noParent; cell = parents[cell])
+		{
+			path.push_back( Vertex( aCluster.xOf( cell), aCluster.yOf( cell)));
+		}
+		std::reverse( path.begin(), path.end());
+		return path;
+	}
+	/**
+	 *
+	 */
+	bool HierarchicalAStar::isFree(	int anX,
+									int anY) const
+	{
+		return extent.contains( anX, anY) && !occupancyGrid.isBlocked( anX, anY);
+	}
+} // namespace PathAlgorithm
@@ -0,0 +1,262 @@
+#ifndef HIERARCHICALASTAR_HPP_
+#define HIERARCHICALASTAR_HPP_
+
+#include "Config.hpp"
+
+#include "GridExtent.hpp"
+#include "IndexedHeap.hpp"
+#include "OccupancyGrid.hpp"
+#include "Planner.hpp"
+
+#include <cstdint>
+#include <map>
+#include <vector>
+
+namespace PathAlgorithm
+{
+	/**
+	 * Hierarchical path-finding A* (HPA*, Botea, Müller and Schaeffer, 2004) on the same 8-connected grid as AStar.
+	 *
+	 * The occupancy grid is partitioned into square clusters. Where two neighbouring clusters share a free stretch of
+	 * border there is an entrance with one or two transitions: a pair of nodes, one on either side of the border. The
+	 * nodes within a cluster are connected by the cost of the shortest path between them within the cluster. This
+	 * abstract graph is cached until the size of the robot changes. If walls move, the occupancy grid is patched
+	 * around them and only the clusters with changed cells get new entrances on their borders and new edges, like
+	 * the neighbouring clusters whose nodes changed. Walls that are added or deleted rebuild the whole graph.
+	 *
+	 * A search connects the start and the goal to the nodes of their clusters, searches the abstract graph and
+	 * refines every abstract edge into pixels within its cluster. The path is not always the shortest path: it can
+	 * only cross between clusters at the transitions.
+	 */
+	class HierarchicalAStar : public Planner
+	{
+		public:
+			/**
+			 *
+			 */
+			explicit HierarchicalAStar( int aClusterSize = 32);
+			/**
+			 *
+			 */
+			virtual Path search(const wxPoint& aStartPoint,
+								const wxPoint& aGoalPoint,
+								const wxSize& aRobotSize) override;
+			/**
+			 * The abstract nodes that were still open at the end of the search
+			 */
+			virtual OpenSet getOpenSet() const override;
+			/**
+			 * The abstract nodes that were expanded by the search
+			 */
+			virtual ClosedSet getClosedSet() const override;
+			/**
+			 *
+			 */
+			int getClusterSize() const
+			{
+				return clusterSize;
+			}
+			/**
+			 *
+			 */
+			virtual std::string getCacheKey() const override
+			{
+				return Planner::getCacheKey() + " " + std::to_string( clusterSize);
+			}
+			/**
+			 *
+			 * @return the number of nodes in the cached abstract graph, without the start and the goal
+			 */
+			std::size_t getNodeCount() const
+			{
+				return nodes.size();
+			}
+
+		private:
+			/**
+			 * An entry of the priority queues of both the abstract search and the searches within a cluster
+			 */
+			struct QueueEntry
+			{
+					std::uint32_t id;
+					double key;
+					double cost;
+			};
+			/**
+			 *
+			 */
+			struct QueueEntryLessKey
+			{
+					bool operator()(	const QueueEntry& lhs,
+										const QueueEntry& rhs) const
+					{
+						// less uncertainty if the actual cost is larger
+						return lhs.key < rhs.key || (lhs.key == rhs.key && lhs.cost > rhs.cost);
+					}
+			};
+			/**
+			 *
+			 */
+			struct QueueEntryId
+			{
+					std::size_t operator()( const QueueEntry& anEntry) const
+					{
+						return anEntry.id;
+					}
+			};
+			/**
+			 *
+			 */
+			typedef Base::IndexedHeap< QueueEntry, QueueEntryLessKey, QueueEntryId > Queue;
+			/**
+			 *
+			 */
+			struct AbstractEdge
+			{
+					std::size_t to;
+					double cost;
+			};
+			/**
+			 * A pair of nodes on either side of a border, inside is in the cluster that owns the border
+			 */
+			struct Transition
+			{
+					wxPoint inside;
+					wxPoint outside;
+			};
+			/**
+			 * An edge between the nodes with the indices from and to in the nodes of a cluster
+			 */
+			struct IntraEdge
+			{
+					std::size_t from;
+					std::size_t to;
+					double cost;
+			};
+			/**
+			 * The nodes of a cluster and the edges between them, the edges stay valid as long as the nodes and the
+			 * cells of the cluster stay the same
+			 */
+			struct ClusterGraph
+			{
+					std::vector< wxPoint > nodes;
+					std::vector< IntraEdge > edges;
+			};
+			/**
+			 * (Re)builds the abstract graph over anExtent
+			 */
+			void build(	const GridExtent& anExtent,
+						int aFreeRadius);
+			/**
+			 * Patches the occupancy grid around the walls that moved and finds the entrances and edges of the
+			 * clusters with changed cells again
+			 *
+			 * @return false if the walls changed in a way that needs a new graph
+			 */
+			bool updateWalls( const WallSnapshot& aWallSnapshot);
+			/**
+			 * Finds the transitions over the right and the bottom border of aCluster
+			 */
+			void addTransitions( const GridExtent& aCluster);
+			/**
+			 * Adds the transitions of the entrances along the border between two clusters to aTransitions. The border
+			 * is the line from aFirst (inclusive) with aLength points in the direction aDirection, the other cluster is
+			 * on the side anAcross.
+			 */
+			void addEntrances(	const wxPoint& aFirst,
+								int aLength,
+								const wxPoint& aDirection,
+								const wxPoint& anAcross,
+								std::vector< Transition >& aTransitions) const;
+			/**
+			 * Creates the nodes and edges of the abstract graph from the transitions and the cluster graphs
+			 */
+			void connect();
+			/**
+			 *
+			 * @return the index of the node at aPoint, a new node if there is none
+			 */
+			std::size_t addNode( const wxPoint& aPoint);
+			/**
+			 * Connects the nodes within every cluster, the cluster graphs whose nodes changed are searched again
+			 */
+			void addIntraEdges();
+			/**
+			 *
+			 */
+			GridExtent getCluster( const wxPoint& aPoint) const;
+			/**
+			 * Dijkstra from aSource to every point of aCluster that can be reached within aCluster.
+			 * The costs and parents are indexed by the cell index in aCluster.
+			 */
+			void searchCluster(	const GridExtent& aCluster,
+								const wxPoint& aSource,
+								std::vector< double >& aCosts,
+								std::vector< std::uint32_t >& aParents) const;
+			/**
+			 * The pixels from aFrom to aTo within the cluster of aFrom, the first point (aFrom) is not included
+			 */
+			Path refine(	const wxPoint& aFrom,
+							const wxPoint& aTo,
+							const GridExtent& aCluster) const;
+			/**
+			 *
+			 */
+			bool isFree(	int anX,
+							int anY) const;
+			/**
+			 *
+			 */
+			int clusterSize;
+			/**
+			 *
+			 */
+			OccupancyGrid occupancyGrid;
+			/**
+			 * The extent of the abstract graph
+			 */
+			GridExtent extent;
+			/**
+			 *
+			 */
+			int freeRadius;
+			/**
+			 * The walls the occupancy grid was made for, to find the walls that moved
+			 */
+			std::vector< WallSegment > walls;
+			/**
+			 *
+			 */
+			bool built;
+			/**
+			 * The transitions over the right and the bottom border per cluster, by the top left point of the cluster
+			 */
+			std::map< std::pair< int, int >, std::vector< Transition > > transitions;
+			/**
+			 * The graph per cluster, by the top left point of the cluster
+			 */
+			std::map< std::pair< int, int >, ClusterGraph > clusterGraphs;
+			/**
+			 *
+			 */
+			std::vector< wxPoint > nodes;
+			/**
+			 * The node at a cell index in the extent
+			 */
+			std::map< std::uint32_t, std::size_t > nodeAtCell;
+			/**
+			 *
+			 */
+			std::vector< std::vector< AbstractEdge > > edges;
+			/**
+			 * The nodes per cluster, by the top left point of the cluster
+			 */
+			std::map< std::pair< int, int >, std::vector< std::size_t > > clusterNodes;
+			/**
+			 * The state of the abstract search, the start and the goal are the last two nodes
+			 */
+			OpenSet openSet;
+			ClosedSet closedSet;
+	}; // class HierarchicalAStar
+} // namespace PathAlgorithm
+#endif // HIERARCHICALASTAR_HPP_
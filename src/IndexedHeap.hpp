@@ -0,0 +1,331 @@
+#ifndef INDEXEDHEAP_HPP_
+#define INDEXEDHEAP_HPP_
+
+#include "Config.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Base
+{
+	/**
+	 * A d-ary heap that keeps track of the position of every element in the heap so that
+	 * an element can be found in O(1) and updated (decrease-key) or removed in O(log n).
+	 *
+	 * Compare( lhs, rhs) must return true if lhs should leave the heap before rhs.
+	 * KeyFunction( anElement) must return a std::size_t that uniquely identifies the element,
+	 * there can be at most one element with a given key in the heap.
+	 *
+	 * By default the position index is a hash map. If the keys are known to be in [0, n) setDenseKeys( n)
+	 * turns the index into a plain vector which does not allocate per element.
+	 */
+	template< typename ElementType, typename Compare, typename KeyFunction, std::size_t Arity = 4 >
+	class IndexedHeap
+	{
+		public:
+			/**
+			 *
+			 */
+			typedef typename std::vector< ElementType >::const_iterator const_iterator;
+			/**
+			 * Returned by find if the element is not in the heap
+			 */
+			static constexpr std::size_t npos = std::numeric_limits< std::size_t >::max();
+			/**
+			 *
+			 */
+			bool empty() const
+			{
+				return elements.empty();
+			}
+			/**
+			 *
+			 */
+			std::size_t size() const
+			{
+				return elements.size();
+			}
+			/**
+			 *
+			 */
+			void reserve( std::size_t aSize)
+			{
+				elements.reserve( aSize);
+				if (!dense)
+				{
+					positions.reserve( aSize);
+				}
+			}
+			/**
+			 *
+			 */
+			void clear()
+			{
+				if (dense)
+				{
+					for (const ElementType& element : elements)
+					{
+						densePositions[key( element)] = npos;
+					}
+				} else
+				{
+					positions.clear();
+				}
+				elements.clear();
+			}
+			/**
+			 * Clears the heap and sets the KeyFunction that is used from now on
+			 */
+			void setKeyFunction( const KeyFunction& aKeyFunction)
+			{
+				clear();
+				key = aKeyFunction;
+			}
+			/**
+			 * Clears the heap. If aKeyCount > 0 all keys must be smaller than aKeyCount and the position index
+			 * becomes a vector of aKeyCount entries, if aKeyCount == 0 the position index is a hash map.
+			 */
+			void setDenseKeys( std::size_t aKeyCount)
+			{
+				clear();
+				dense = aKeyCount > 0;
+				if (dense)
+				{
+					positions.clear();
+					densePositions.assign( aKeyCount, npos);
+				} else
+				{
+					densePositions.clear();
+				}
+			}
+			/**
+			 * @return the element that should leave the heap first
+			 */
+			const ElementType& top() const
+			{
+				return elements.front();
+			}
+			/**
+			 * Adds the element to the heap. The key of the element may not be in the heap yet.
+			 */
+			void push( const ElementType& anElement)
+			{
+				elements.push_back( anElement);
+				setPosition( key( anElement), elements.size() - 1);
+				siftUp( elements.size() - 1);
+			}
+			/**
+			 * Removes the top element
+			 */
+			void pop()
+			{
+				erase( 0);
+			}
+			/**
+			 * @return the position of the element with the given key, npos if there is no such element
+			 */
+			std::size_t find( std::size_t aKey) const
+			{
+				if (dense)
+				{
+					return densePositions[aKey];
+				}
+				auto i = positions.find( aKey);
+				if (i == positions.end())
+				{
+					return npos;
+				}
+				return i->second;
+			}
+			/**
+			 * @return the position of the element with the same key as anElement, npos if there is no such element
+			 */
+			std::size_t find( const ElementType& anElement) const
+			{
+				return find( key( anElement));
+			}
+			/**
+			 *
+			 */
+			const ElementType& at( std::size_t aPosition) const
+			{
+				return elements[aPosition];
+			}
+			/**
+			 * Replaces the element at aPosition and restores the heap order, works for both
+			 * decrease-key and increase-key. The key of the element may not change.
+			 */
+			void update(	std::size_t aPosition,
+							const ElementType& anElement)
+			{
+				elements[aPosition] = anElement;
+				siftUp( aPosition);
+				siftDown( aPosition);
+			}
+			/**
+			 *
+			 */
+			void erase( std::size_t aPosition)
+			{
+				erasePosition( key( elements[aPosition]));
+
+				std::size_t last = elements.size() - 1;
+				if (aPosition != last)
+				{
+					elements[aPosition] = std::move( elements[last]);
+					setPosition( key( elements[aPosition]), aPosition);
+					elements.pop_back();
+					siftUp( aPosition);
+					siftDown( aPosition);
+				} else
+				{
+					elements.pop_back();
+				}
+			}
+			/**
+			 * @return true if an element with the same key as anElement was found and removed
+			 */
+			bool erase( const ElementType& anElement)
+			{
+				std::size_t position = find( anElement);
+				if (position == npos)
+				{
+					return false;
+				}
+				erase( position);
+				return true;
+			}
+			/**
+			 * Iteration is in heap order, not in sorted order
+			 */
+			const_iterator begin() const
+			{
+				return elements.begin();
+			}
+			/**
+			 *
+			 */
+			const_iterator end() const
+			{
+				return elements.end();
+			}
+
+		private:
+			/**
+			 *
+			 */
+			void siftUp( std::size_t aPosition)
+			{
+				ElementType element = std::move( elements[aPosition]);
+				while (aPosition > 0)
+				{
+					std::size_t parent = (aPosition - 1) / Arity;
+					if (!compare( element, elements[parent]))
+					{
+						break;
+					}
+					place( aPosition, std::move( elements[parent]));
+					aPosition = parent;
+				}
+				place( aPosition, std::move( element));
+			}
+			/**
+			 *
+			 */
+			void siftDown( std::size_t aPosition)
+			{
+				std::size_t size = elements.size();
+				ElementType element = std::move( elements[aPosition]);
+				for (;;)
+				{
+					std::size_t firstChild = aPosition * Arity + 1;
+					if (firstChild >= size)
+					{
+						break;
+					}
+					std::size_t lastChild = std::min( firstChild + Arity, size);
+					std::size_t bestChild = firstChild;
+					for (std::size_t child = firstChild + 1; child < lastChild; ++child)
+					{
+						if (compare( elements[child], elements[bestChild]))
+						{
+							bestChild = child;
+						}
+					}
+					if (!compare( elements[bestChild], element))
+					{
+						break;
+					}
+					place( aPosition, std::move( elements[bestChild]));
+					aPosition = bestChild;
+				}
+				place( aPosition, std::move( element));
+			}
+			/**
+			 *
+			 */
+			void place( std::size_t aPosition,
+						ElementType&& anElement)
+			{
+				elements[aPosition] = std::move( anElement);
+				setPosition( key( elements[aPosition]), aPosition);
+			}
+			/**
+			 *
+			 */
+			void setPosition(	std::size_t aKey,
+								std::size_t aPosition)
+			{
+				if (dense)
+				{
+					densePositions[aKey] = aPosition;
+				} else
+				{
+					positions[aKey] = aPosition;
+				}
+			}
+			/**
+			 *
+			 */
+			void erasePosition( std::size_t aKey)
+			{
+				if (dense)
+				{
+					densePositions[aKey] = npos;
+				} else
+				{
+					positions.erase( aKey);
+				}
+			}
+			/**
+			 *
+			 */
+			std::vector< ElementType > elements;
+			/**
+			 * Maps the key of an element to its position in elements
+			 */
+			std::unordered_map< std::size_t, std::size_t > positions;
+			/**
+			 * Used instead of positions if the keys are dense
+			 */
+			std::vector< std::size_t > densePositions;
+			/**
+			 *
+			 */
+			bool dense = false;
+			/**
+			 *
+			 */
+			Compare compare;
+			/**
+			 *
+			 */
+			KeyFunction key;
+	};
+	// class IndexedHeap
+} // namespace Base
+#endif // INDEXEDHEAP_HPP_
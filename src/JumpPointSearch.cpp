@@ -0,0 +1,213 @@
+#include "JumpPointSearch.hpp"
+
+#include "GridConnectivity.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <utility>
+
+namespace PathAlgorithm
+{
+	/**
+	 *
+	 */
+	int Sign( int aValue)
+	{
+		return (aValue > 0) - (aValue < 0);
+	}
+	/**
+	 *
+	 */
+	JumpPointSearch::JumpPointSearch()
+	{
+	}
+	/**
+	 *
+	 */
+	void JumpPointSearch::getConnections(	const Vertex& aVertex,
+											const Vertex& aGoal,
+											std::vector< Edge >& aConnections)
+	{
+		int x = aVertex.x;
+		int y = aVertex.y;
+
+		// The directions to jump in: all of them from the start, otherwise the natural
+		// neighbours in the direction of travel plus the forced neighbours
+		std::pair< int, int > directions[8];
+		std::size_t directionCount = 0;
+
+		Vertex predecessor( 0, 0);
+		if (!findPredecessor( aVertex, predecessor))
+		{
+			for (int i = 0; i < EightConnected::moves; ++i)
+			{
+				directions[directionCount++] = std::make_pair( EightConnected::xOffset[i], EightConnected::yOffset[i]);
+			}
+		} else
+		{
+			int dx = Sign( x - predecessor.x);
+			int dy = Sign( y - predecessor.y);
+
+			if (dx != 0 && dy != 0)
+			{
+				directions[directionCount++] = std::make_pair( 0, dy);
+				directions[directionCount++] = std::make_pair( dx, 0);
+				directions[directionCount++] = std::make_pair( dx, dy);
+				if (!isFree( x - dx, y))
+				{
+					directions[directionCount++] = std::make_pair( -dx, dy);
+				}
+				if (!isFree( x, y - dy))
+				{
+					directions[directionCount++] = std::make_pair( dx, -dy);
+				}
+			} else if (dx == 0)
+			{
+				directions[directionCount++] = std::make_pair( 0, dy);
+				if (!isFree( x + 1, y))
+				{
+					directions[directionCount++] = std::make_pair( 1, dy);
+				}
+				if (!isFree( x - 1, y))
+				{
+					directions[directionCount++] = std::make_pair( -1, dy);
+				}
+			} else
+			{
+				directions[directionCount++] = std::make_pair( dx, 0);
+				if (!isFree( x, y + 1))
+				{
+					directions[directionCount++] = std::make_pair( dx, 1);
+				}
+				if (!isFree( x, y - 1))
+				{
+					directions[directionCount++] = std::make_pair( dx, -1);
+				}
+			}
+		}
+
+		aConnections.clear();
+		for (std::size_t i = 0; i < directionCount; ++i)
+		{
+			Vertex jumpPoint( 0, 0);
+			if (jump( aVertex, directions[i].first, directions[i].second, aGoal, jumpPoint))
+			{
+				aConnections.push_back( Edge( aVertex, jumpPoint));
+			}
+		}
+	}
+	/**
+	 *
+	 */
+	void JumpPointSearch::constructPath(	const Vertex& aGoal,
+											Path& aPath)
+	{
+		AStar::constructPath( aGoal, jumpPoints);
+
+		aPath.clear();
+		if (jumpPoints.empty())
+		{
+			return;
+		}
+
+		aPath.push_back( jumpPoints.front());
+		aPath.back().actualCost = 0.0;
+		for (std::size_t i = 1; i < jumpPoints.size(); ++i)
+		{
+			const Vertex from = aPath.back();
+			const Vertex& to = jumpPoints[i];
+
+			int dx = Sign( to.x - from.x);
+			int dy = Sign( to.y - from.y);
+			int steps = std::max( std::abs( to.x - from.x), std::abs( to.y - from.y));
+			double stepCost = (dx != 0 && dy != 0) ? std::sqrt( 2.0) : 1.0;
+			for (int step = 1; step <= steps; ++step)
+			{
+				Vertex vertex( from.x + step * dx, from.y + step * dy);
+				vertex.actualCost = from.actualCost + step * stepCost;
+				aPath.push_back( vertex);
+			}
+		}
+	}
+	/**
+	 *
+	 */
+	bool JumpPointSearch::isFree(	int anX,
+									int anY) const
+	{
+		return getSearchExtent().contains( anX, anY) && !getOccupancyGrid().isBlocked( anX, anY);
+	}
+	/**
+	 *
+	 */
+	bool JumpPointSearch::jump(	const Vertex& aVertex,
+								int aDeltaX,
+								int aDeltaY,
+								const Vertex& aGoal,
+								Vertex& aJumpPoint) const
+	{
+		if (aDeltaX == 0 || aDeltaY == 0)
+		{
+			return jumpStraight( aVertex.x, aVertex.y, aDeltaX, aDeltaY, aGoal, aJumpPoint);
+		}
+
+		int x = aVertex.x;
+		int y = aVertex.y;
+		Vertex straightJumpPoint( 0, 0);
+		for (;;)
+		{
+			x += aDeltaX;
+			y += aDeltaY;
+			if (!isFree( x, y))
+			{
+				return false;
+			}
+			if ((x == aGoal.x && y == aGoal.y) ||
+				(isFree( x - aDeltaX, y + aDeltaY) && !isFree( x - aDeltaX, y)) ||
+				(isFree( x + aDeltaX, y - aDeltaY) && !isFree( x, y - aDeltaY)) ||
+				jumpStraight( x, y, aDeltaX, 0, aGoal, straightJumpPoint) ||
+				jumpStraight( x, y, 0, aDeltaY, aGoal, straightJumpPoint))
+			{
+				aJumpPoint = Vertex( x, y);
+				return true;
+			}
+		}
+	}
+	/**
+	 *
+	 */
+	bool JumpPointSearch::jumpStraight(	int anX,
+										int anY,
+										int aDeltaX,
+										int aDeltaY,
+										const Vertex& aGoal,
+										Vertex& aJumpPoint) const
+	{
+		int x = anX;
+		int y = anY;
+		for (;;)
+		{
+			x += aDeltaX;
+			y += aDeltaY;
+			if (!isFree( x, y))
+			{
+				return false;
+			}
+
+			bool forced;
+			if (aDeltaX != 0)
+			{
+				forced = (isFree( x + aDeltaX, y + 1) && !isFree( x, y + 1)) || (isFree( x + aDeltaX, y - 1) && !isFree( x, y - 1));
+			} else
+			{
+				forced = (isFree( x + 1, y + aDeltaY) && !isFree( x + 1, y)) || (isFree( x - 1, y + aDeltaY) && !isFree( x - 1, y));
+			}
+			if ((x == aGoal.x && y == aGoal.y) || forced)
+			{
+				aJumpPoint = Vertex( x, y);
+				return true;
+			}
+		}
+	}
+} // namespace PathAlgorithm
@@ -0,0 +1,79 @@
+#ifndef JUMPPOINTSEARCH_HPP_
+#define JUMPPOINTSEARCH_HPP_
+
+#include "Config.hpp"
+
+#include "AStar.hpp"
+
+namespace PathAlgorithm
+{
+	/**
+	 * Jump Point Search (Harabor and Grastien, 2011) on the same 8-connected grid as AStar.
+	 *
+	 * Instead of opening every free neighbour the search jumps along straight and diagonal lines
+	 * and only opens the points where the shortest paths can change direction (a forced neighbour
+	 * appears next to the line) or the goal. The open and closed sets therefore only contain jump points.
+	 *
+	 * The path between two jump points is a straight or diagonal line which is filled in again, so
+	 * the path has the same cost as the path found by AStar and has one Vertex per pixel like it.
+	 * Like AStar, a diagonal step is allowed next to a blocked point.
+	 */
+	class JumpPointSearch : public AStar
+	{
+		public:
+			/**
+			 *
+			 */
+			JumpPointSearch();
+
+		protected:
+			/**
+			 * The jump points reached from aVertex in the directions that are not pruned
+			 */
+			virtual void getConnections(	const Vertex& aVertex,
+											const Vertex& aGoal,
+											std::vector< Edge >& aConnections) override;
+			/**
+			 * The path along the jump points, filled in to one Vertex per pixel
+			 */
+			virtual void constructPath(	const Vertex& aGoal,
+											Path& aPath) override;
+			/**
+			 * The jumps depend on the direction of travel, so a JumpPointSearch always searches Forward
+			 */
+			virtual bool hasReversibleConnections() const override
+			{
+				return false;
+			}
+
+		private:
+			/**
+			 * A point can be on the path if it is inside the search extent and not blocked
+			 */
+			bool isFree(	int anX,
+							int anY) const;
+			/**
+			 *
+			 * @return true if a jump point was found, aJumpPoint is set to that point
+			 */
+			bool jump(	const Vertex& aVertex,
+						int aDeltaX,
+						int aDeltaY,
+						const Vertex& aGoal,
+						Vertex& aJumpPoint) const;
+			/**
+			 * A jump along a horizontal (aDeltaY == 0) or a vertical (aDeltaX == 0) line
+			 */
+			bool jumpStraight(	int anX,
+								int anY,
+								int aDeltaX,
+								int aDeltaY,
+								const Vertex& aGoal,
+								Vertex& aJumpPoint) const;
+			/**
+			 * Reused by constructPath
+			 */
+			Path jumpPoints;
+	}; // class JumpPointSearch
+} // namespace PathAlgorithm
+#endif // JUMPPOINTSEARCH_HPP_
@@ -0,0 +1,95 @@
+#include "OccupancyGrid.hpp"
+
+#include "Shape2DUtils.hpp"
+
+#include <algorithm>
+
+namespace PathAlgorithm
+{
+	/**
+	 *
+	 */
+	OccupancyGrid::OccupancyGrid() :
+					freeRadius( 0),
+					wallsVersion( 0),
+					built( false)
+	{
+	}
+	/**
+	 *
+	 */
+	void OccupancyGrid::build(	const ClearanceMap& aClearanceMap,
+								int aFreeRadius)
+	{
+		extent = aClearanceMap.getExtent();
+		blocked.resize( extent.size());
+
+		std::int32_t squaredRadius = aFreeRadius * aFreeRadius;
+		for (int y = extent.top; y <= extent.bottom(); ++y)
+		{
+			for (int x = extent.left; x <= extent.right(); ++x)
+			{
+				blocked[extent.index( x, y)] = aClearanceMap.getSquaredClearance( x, y) < squaredRadius;
+			}
+		}
+
+		freeRadius = aFreeRadius;
+		wallsVersion = aClearanceMap.getWallsVersion();
+		built = true;
+	}
+	/**
+	 *
+	 */
+	void OccupancyGrid::update(	const GridExtent& aRegion,
+								const std::vector< WallSegment >& aWalls,
+								unsigned long aWallsVersion,
+								std::vector< std::uint32_t >& aChangedCells)
+	{
+		GridExtent region = aRegion.intersected( extent);
+
+		// Every wall pixel blocks the points that are less than the free radius away, like in the ClearanceMap
+		GridExtent reach = region.inflated( freeRadius);
+		std::int64_t squaredRadius = static_cast< std::int64_t >( freeRadius) * freeRadius;
+		std::vector< std::uint8_t > regionBlocked( region.size(), 0);
+		std::vector< wxPoint > pixels;
+		for (const WallSegment& wall : aWalls)
+		{
+			if (GridExtent::fromCorners( wall.first, wall.second).intersected( reach).empty())
+			{
+				continue;
+			}
+			pixels.clear();
+			RasteriseWall( wall, pixels);
+			for (const wxPoint& pixel : pixels)
+			{
+				GridExtent disc = GridExtent::fromCorners( pixel, pixel).inflated( freeRadius).intersected( region);
+				for (int y = disc.top; y <= disc.bottom(); ++y)
+				{
+					for (int x = disc.left; x <= disc.right(); ++x)
+					{
+						if (Utils::Shape2DUtils::getSquaredDistance( wxPoint( x, y), pixel) < squaredRadius)
+						{
+							regionBlocked[region.index( x, y)] = 1;
+						}
+					}
+				}
+			}
+		}
+
+		for (int y = region.top; y <= region.bottom(); ++y)
+		{
+			for (int x = region.left; x <= region.right(); ++x)
+			{
+				std::uint8_t isBlocked = regionBlocked[region.index( x, y)];
+				std::uint32_t index = extent.index( x, y);
+				if (blocked[index] != isBlocked)
+				{
+					blocked[index] = isBlocked;
+					aChangedCells.push_back( index);
+				}
+			}
+		}
+
+		wallsVersion = aWallsVersion;
+	}
+} // namespace PathAlgorithm
@@ -0,0 +1,97 @@
+#ifndef OCCUPANCYGRID_HPP_
+#define OCCUPANCYGRID_HPP_
+
+#include "Config.hpp"
+
+#include "ClearanceMap.hpp"
+#include "GridExtent.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace PathAlgorithm
+{
+
+	/**
+	 * A raster of the walls, inflated by the free radius of a robot: a point is blocked
+	 * if the ClearanceMap says a robot with that radius does not fit at that point.
+	 * Points outside the extent of the grid are never blocked.
+	 */
+	class OccupancyGrid
+	{
+		public:
+			/**
+			 *
+			 */
+			OccupancyGrid();
+			/**
+			 * The extent of the grid becomes the extent of the clearance map, the margin of the map must be at least aFreeRadius
+			 */
+			void build(	const ClearanceMap& aClearanceMap,
+						int aFreeRadius);
+			/**
+			 * Recomputes the points in aRegion from aWalls, to patch the grid after some walls moved without deriving
+			 * it from a new ClearanceMap. The distance is measured to the rasterised walls like a ClearanceMap does,
+			 * so the patched points are the points build would give. The indices of the cells that changed from free
+			 * to blocked or the other way round are appended to aChangedCells.
+			 */
+			void update(	const GridExtent& aRegion,
+							const std::vector< WallSegment >& aWalls,
+							unsigned long aWallsVersion,
+							std::vector< std::uint32_t >& aChangedCells);
+			/**
+			 * @return true if the grid was built for the given free radius and version of the walls
+			 */
+			bool isBuiltFor(	int aFreeRadius,
+								unsigned long aWallsVersion) const
+			{
+				return built && freeRadius == aFreeRadius && wallsVersion == aWallsVersion;
+			}
+			/**
+			 *
+			 */
+			bool isBlocked(	int anX,
+							int anY) const
+			{
+				return extent.contains( anX, anY) && blocked[extent.index( anX, anY)] != 0;
+			}
+			/**
+			 *
+			 */
+			const GridExtent& getExtent() const
+			{
+				return extent;
+			}
+			/**
+			 *
+			 */
+			int getFreeRadius() const
+			{
+				return freeRadius;
+			}
+
+		private:
+			/**
+			 *
+			 */
+			GridExtent extent;
+			/**
+			 * One byte per cell, non-zero if blocked
+			 */
+			std::vector< std::uint8_t > blocked;
+			/**
+			 *
+			 */
+			int freeRadius;
+			/**
+			 *
+			 */
+			unsigned long wallsVersion;
+			/**
+			 *
+			 */
+			bool built;
+	};
+	// class OccupancyGrid
+} // namespace PathAlgorithm
+#endif // OCCUPANCYGRID_HPP_
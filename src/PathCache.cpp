@@ -0,0 +1,152 @@
+#include "PathCache.hpp"
+
+#include <functional>
+
+namespace PathAlgorithm
+{
+	/**
+	 *
+	 */
+	/* static */PathCache& PathCache::getPathCache()
+	{
+		static PathCache pathCache;
+		return pathCache;
+	}
+	/**
+	 *
+	 */
+	PathCache::PathCache() :
+								capacity( 256),
+								hits( 0),
+								misses( 0)
+	{
+	}
+	/**
+	 *
+	 */
+	bool PathCache::find(	const Planner& aPlanner,
+							std::uint64_t aWallsHash,
+							const wxPoint& aStartPoint,
+							const wxPoint& aGoalPoint,
+							const wxSize& aRobotSize,
+							Path& aPath)
+	{
+		Key key{ aPlanner.getCacheKey(), aWallsHash, aStartPoint, aGoalPoint, aRobotSize};
+
+		std::lock_guard< std::mutex > guard( cacheMutex);
+
+		auto i = index.find( key);
+		if (i == index.end())
+		{
+			++misses;
+			return false;
+		}
+		++hits;
+
+		entries.splice( entries.begin(), entries, i->second);
+		aPath = i->second->second;
+		return true;
+	}
+	/**
+	 *
+	 */
+	void PathCache::insert(	const Planner& aPlanner,
+							std::uint64_t aWallsHash,
+							const wxPoint& aStartPoint,
+							const wxPoint& aGoalPoint,
+							const wxSize& aRobotSize,
+							const Path& aPath)
+	{
+		Key key{ aPlanner.getCacheKey(), aWallsHash, aStartPoint, aGoalPoint, aRobotSize};
+
+		std::lock_guard< std::mutex > guard( cacheMutex);
+
+		if (capacity == 0)
+		{
+			return;
+		}
+
+		auto i = index.find( key);
+		if (i != index.end())
+		{
+			entries.splice( entries.begin(), entries, i->second);
+			i->second->second = aPath;
+			return;
+		}
+
+		entries.emplace_front( key, aPath);
+		index.emplace( key, entries.begin());
+		shrink();
+	}
+	/**
+	 *
+	 */
+	void PathCache::clear()
+	{
+		std::lock_guard< std::mutex > guard( cacheMutex);
+
+		index.clear();
+		entries.clear();
+	}
+	/**
+	 *
+	 */
+	void PathCache::setCapacity( std::size_t aCapacity)
+	{
+		std::lock_guard< std::mutex > guard( cacheMutex);
+
+		capacity = aCapacity;
+		shrink();
+	}
+	/**
+	 *
+	 */
+	std::size_t PathCache::getCapacity() const
+	{
+		std::lock_guard< std::mutex > guard( cacheMutex);
+		return capacity;
+	}
+	/**
+	 *
+	 */
+	std::size_t PathCache::size() const
+	{
+		std::lock_guard< std::mutex > guard( cacheMutex);
+		return entries.size();
+	}
+	/**
+	 *
+	 */
+	std::pair< std::size_t, std::size_t > PathCache::getHitsAndMisses() const
+	{
+		std::lock_guard< std::mutex > guard( cacheMutex);
+		return std::make_pair( hits, misses);
+	}
+	/**
+	 *
+	 */
+	void PathCache::shrink()
+	{
+		while (entries.size() > capacity)
+		{
+			index.erase( entries.back().first);
+			entries.pop_back();
+		}
+	}
+	/**
+	 *
+	 */
+	std::size_t PathCache::KeyHash::operator()( const Key& aKey) const
+	{
+		// Combines the fields the way boost::hash_combine does
+		std::size_t hash = std::hash< std::string >()( aKey.planner);
+		for (std::size_t value : { static_cast< std::size_t >( aKey.wallsHash),
+									static_cast< std::size_t >( aKey.startPoint.x), static_cast< std::size_t >( aKey.startPoint.y),
+									static_cast< std::size_t >( aKey.goalPoint.x), static_cast< std::size_t >( aKey.goalPoint.y),
+									static_cast< std::size_t >( aKey.robotSize.x), static_cast< std::size_t >( aKey.robotSize.y)})
+		{
+			hash ^= std::hash< std::size_t >()( value) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+		}
+		return hash;
+	}
+} // namespace PathAlgorithm
@@ -0,0 +1,138 @@
+#ifndef PATHCACHE_HPP_
+#define PATHCACHE_HPP_
+
+#include "Config.hpp"
+
+#include "Planner.hpp"
+#include "Point.hpp"
+#include "Size.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace PathAlgorithm
+{
+	/**
+	 * The paths that were found for the walls of the RobotWorld, so that the same query does not have to be searched
+	 * again, e.g. when a robot starts driving to the same goal again after the world was reset.
+	 *
+	 * A path is kept per configuration of the planner (Planner::getCacheKey), geometry of the walls
+	 * (WallSnapshot::getWallsHash), start, goal and size of the robot. A path for other walls is not removed when the
+	 * walls change, the same walls may come back. The least recently used path is removed if the cache is full. The
+	 * cache may be used by any thread.
+	 */
+	class PathCache
+	{
+		public:
+			/**
+			 *
+			 */
+			static PathCache& getPathCache();
+			/**
+			 * @return true if there is a path for the query, it is copied into aPath
+			 */
+			bool find(	const Planner& aPlanner,
+						std::uint64_t aWallsHash,
+						const wxPoint& aStartPoint,
+						const wxPoint& aGoalPoint,
+						const wxSize& aRobotSize,
+						Path& aPath);
+			/**
+			 * Keeps aPath for the query, a path for the same query is replaced
+			 */
+			void insert(const Planner& aPlanner,
+						std::uint64_t aWallsHash,
+						const wxPoint& aStartPoint,
+						const wxPoint& aGoalPoint,
+						const wxSize& aRobotSize,
+						const Path& aPath);
+			/**
+			 * Removes all paths
+			 */
+			void clear();
+			/**
+			 * The maximum number of paths, 0 turns the cache off
+			 */
+			void setCapacity( std::size_t aCapacity);
+			/**
+			 *
+			 */
+			std::size_t getCapacity() const;
+			/**
+			 *
+			 */
+			std::size_t size() const;
+			/**
+			 * @return the number of queries that were found and that were not found since the start of the program
+			 */
+			std::pair< std::size_t, std::size_t > getHitsAndMisses() const;
+
+		private:
+			/**
+			 *
+			 */
+			struct Key
+			{
+					std::string planner;
+					std::uint64_t wallsHash;
+					wxPoint startPoint;
+					wxPoint goalPoint;
+					wxSize robotSize;
+
+					bool operator==( const Key& aKey) const
+					{
+						return planner == aKey.planner && wallsHash == aKey.wallsHash && startPoint == aKey.startPoint && goalPoint == aKey.goalPoint && robotSize == aKey.robotSize;
+					}
+			};
+			/**
+			 *
+			 */
+			struct KeyHash
+			{
+					std::size_t operator()( const Key& aKey) const;
+			};
+			/**
+			 * The most recently used entry is at the front
+			 */
+			typedef std::list< std::pair< Key, Path > > Entries;
+			/**
+			 * 256 paths
+			 */
+			PathCache();
+			/**
+			 * Removes the least recently used entries until there are at most capacity left, requires the lock
+			 */
+			void shrink();
+			/**
+			 * Guards everything below
+			 */
+			mutable std::mutex cacheMutex;
+			/**
+			 *
+			 */
+			Entries entries;
+			/**
+			 *
+			 */
+			std::unordered_map< Key, Entries::iterator, KeyHash > index;
+			/**
+			 *
+			 */
+			std::size_t capacity;
+			/**
+			 *
+			 */
+			std::size_t hits;
+			/**
+			 *
+			 */
+			std::size_t misses;
+	};
+	// class PathCache
+} // namespace PathAlgorithm
+#endif // PATHCACHE_HPP_
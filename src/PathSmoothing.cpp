@@ -0,0 +1,93 @@
+#include "PathSmoothing.hpp"
+
+#include "Shape2DUtils.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace PathAlgorithm
+{
+	/**
+	 * @return true if the line segments cross or come less than aRadius near each other, in particular if they touch
+	 * and aRadius is more than 0
+	 */
+	bool IsNearWall(	const wxPoint& aPoint1,
+						const wxPoint& aPoint2,
+						const WallSegment& aWall,
+						int aRadius)
+	{
+		if (Utils::Shape2DUtils::getOrientation( aPoint1, aPoint2, aWall.first) * Utils::Shape2DUtils::getOrientation( aPoint1, aPoint2, aWall.second) < 0 &&
+			Utils::Shape2DUtils::getOrientation( aWall.first, aWall.second, aPoint1) * Utils::Shape2DUtils::getOrientation( aWall.first, aWall.second, aPoint2) < 0)
+		{
+			return true;
+		}
+		if (aRadius <= 0)
+		{
+			return false;
+		}
+		// Otherwise the closest points include an end point, touching and collinear segments are near here as well
+		return Utils::Shape2DUtils::isNearSegment( aWall.first, aWall.second, aPoint1, aRadius) ||
+				Utils::Shape2DUtils::isNearSegment( aWall.first, aWall.second, aPoint2, aRadius) ||
+				Utils::Shape2DUtils::isNearSegment( aPoint1, aPoint2, aWall.first, aRadius) ||
+				Utils::Shape2DUtils::isNearSegment( aPoint1, aPoint2, aWall.second, aRadius);
+	}
+	/**
+	 *
+	 */
+	bool IsLineOfSight(	const wxPoint& aPoint1,
+						const wxPoint& aPoint2,
+						int aFreeRadius,
+						const std::vector< WallSegment >& aWalls)
+	{
+		int clearance = std::max( aFreeRadius - 1, 0);
+		int left = std::min( aPoint1.x, aPoint2.x) - aFreeRadius;
+		int right = std::max( aPoint1.x, aPoint2.x) + aFreeRadius;
+		int top = std::min( aPoint1.y, aPoint2.y) - aFreeRadius;
+		int bottom = std::max( aPoint1.y, aPoint2.y) + aFreeRadius;
+
+		for (const WallSegment& wall : aWalls)
+		{
+			// A wall outside the box around the line is too far away
+			if (std::max( wall.first.x, wall.second.x) < left || std::min( wall.first.x, wall.second.x) > right ||
+				std::max( wall.first.y, wall.second.y) < top || std::min( wall.first.y, wall.second.y) > bottom)
+			{
+				continue;
+			}
+			if (IsNearWall( aPoint1, aPoint2, wall, clearance))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+	/**
+	 *
+	 */
+	void SmoothPath(	Path& aPath,
+						int aFreeRadius,
+						const std::vector< WallSegment >& aWalls,
+						std::size_t aFirstVertex /*= 0*/)
+	{
+		if (aPath.size() < aFirstVertex + 3)
+		{
+			return;
+		}
+
+		// The kept vertices are moved to the front of aPath, anchor is the last one of them
+		std::size_t anchor = aFirstVertex;
+		for (std::size_t i = aFirstVertex + 2; i < aPath.size(); ++i)
+		{
+			if (!IsLineOfSight( aPath[anchor].asPoint(), aPath[i].asPoint(), aFreeRadius, aWalls))
+			{
+				Vertex corner = aPath[i - 1];
+				corner.actualCost = aPath[anchor].actualCost + std::hypot( corner.x - aPath[anchor].x, corner.y - aPath[anchor].y);
+				aPath[++anchor] = corner;
+			}
+		}
+		Vertex goal = aPath.back();
+		goal.actualCost = aPath[anchor].actualCost + std::hypot( goal.x - aPath[anchor].x, goal.y - aPath[anchor].y);
+		aPath[++anchor] = goal;
+		aPath.erase( aPath.begin() + static_cast< std::ptrdiff_t >( anchor + 1), aPath.end());
+		aPath.shrink_to_fit();
+	}
+} // namespace PathAlgorithm
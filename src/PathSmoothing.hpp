@@ -0,0 +1,35 @@
+#ifndef PATHSMOOTHING_HPP_
+#define PATHSMOOTHING_HPP_
+
+#include "Config.hpp"
+
+#include "ClearanceMap.hpp"
+#include "Planner.hpp"
+#include "Point.hpp"
+
+#include <cstddef>
+#include <vector>
+
+namespace PathAlgorithm
+{
+	/**
+	 * A robot with aFreeRadius can drive in a straight line from aPoint1 to aPoint2 if the line keeps that far from
+	 * every wall. The grid planners measure the distance to the rasterised walls, so the line may come up to one
+	 * pixel closer to a wall than the radius, like the vertices of their paths.
+	 */
+	bool IsLineOfSight(	const wxPoint& aPoint1,
+						const wxPoint& aPoint2,
+						int aFreeRadius,
+						const std::vector< WallSegment >& aWalls);
+	/**
+	 * String-pulls aPath from aFirstVertex on: a vertex is only kept if the robot cannot drive in a straight line
+	 * (see IsLineOfSight) from the previous kept vertex to the vertex after it. A path of one vertex per pixel shrinks
+	 * to the corners around which it bends, the actual costs of the kept vertices are the lengths of the new path.
+	 * The vertices before aFirstVertex are kept as they are, e.g. because they are timed.
+	 */
+	void SmoothPath(	Path& aPath,
+						int aFreeRadius,
+						const std::vector< WallSegment >& aWalls,
+						std::size_t aFirstVertex = 0);
+} // namespace PathAlgorithm
+#endif // PATHSMOOTHING_HPP_
@@ -0,0 +1,48 @@
+#include "Planner.hpp"
+
+#include "RobotWorld.hpp"
+
+namespace PathAlgorithm
+{
+	/**
+	 *
+	 */
+	WallSnapshotPtr Planner::getWallSnapshot() const
+	{
+		if (wallSnapshot)
+		{
+			return wallSnapshot;
+		}
+		return Model::RobotWorld::getRobotWorld().getWallSnapshot();
+	}
+	/**
+	 *
+	 */
+	void Planner::beginProgress()
+	{
+		unreportedExpansions = 0;
+		if (progressTimeInterval.count() != 0)
+		{
+			lastProgress = std::chrono::steady_clock::now();
+		}
+	}
+	/**
+	 *
+	 */
+	void Planner::publishProgress()
+	{
+		notifyObservers();
+		unreportedExpansions = 0;
+		if (progressTimeInterval.count() != 0)
+		{
+			lastProgress = std::chrono::steady_clock::now();
+		}
+	}
+	/**
+	 *
+	 */
+	bool Planner::isProgressIntervalPassed() const
+	{
+		return std::chrono::steady_clock::now() - lastProgress >= progressTimeInterval;
+	}
+} // namespace PathAlgorithm
@@ -0,0 +1,424 @@
+#ifndef PLANNER_HPP_
+#define PLANNER_HPP_
+
+#include "Config.hpp"
+
+#include "Notifier.hpp"
+#include "Point.hpp"
+#include "ReservationTable.hpp"
+#include "Size.hpp"
+#include "WallSnapshot.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+namespace PathAlgorithm
+{
+	/**
+	 * A Vertex is the dot in a graph.
+	 */
+	struct Vertex
+	{
+			/**
+			 *
+			 */
+			Vertex( int anX,
+					int anY) :
+						x( anX),
+						y( anY),
+						actualCost( 0.0),
+						heuristicCost( 0.0)
+			{
+			}
+			/**
+			 *
+			 */
+			explicit Vertex( const wxPoint& aPoint) :
+				x( aPoint.x),
+				y( aPoint.y),
+				actualCost( 0.0),
+				heuristicCost( 0.0)
+			{
+			}
+			/**
+			 *
+			 */
+			 Vertex( const Vertex&) = default;
+			/**
+			 *
+			 */
+			 Vertex( Vertex&&) = default;
+			/**
+			 *
+			 */
+			 Vertex& operator=( const Vertex&) = default;
+			/**
+			 *
+			 */
+			wxPoint asPoint() const
+			{
+				return wxPoint( x, y);
+			}
+			/**
+			 *
+			 */
+			bool lessCost( const Vertex& aVertex) const
+			{
+				if (heuristicCost < aVertex.heuristicCost)
+					return true;
+				// less uncertainty if the actual cost is smaller
+				if (heuristicCost == aVertex.heuristicCost)
+					return actualCost > aVertex.actualCost;
+				return false;
+			}
+			/**
+			 *
+			 */
+			bool lessId( const Vertex& aVertex) const
+			{
+				if ( x < aVertex.x) return true;
+				if ( x == aVertex.x) return y < aVertex.y;
+				return false;
+			}
+			/**
+			 *
+			 */
+			bool equalPoint( const Vertex& aVertex) const
+			{
+				return x == aVertex.x && y == aVertex.y;
+			}
+
+			int x;
+			int y;
+
+			double actualCost;
+			double heuristicCost;
+	};
+	// struct Vertex
+
+	/**
+	 *
+	 */
+	struct VertexLessCostCompare
+	{
+			bool operator()(	const Vertex& lhs,
+								const Vertex& rhs) const
+			{
+				return lhs.lessCost( rhs);
+			}
+	};
+	// struct VertexCostCompare
+	/**
+	 *
+	 */
+	struct VertexLessIdCompare
+	{
+			bool operator()(	const Vertex& lhs,
+								const Vertex& rhs) const
+			{
+				return lhs.lessId( rhs);
+			}
+	};
+	// struct VertexIdCompare
+	/**
+	 *
+	 */
+	struct VertexEqualPointCompare
+	{
+			bool operator()(	const Vertex& lhs,
+								const Vertex& rhs) const
+			{
+				return lhs.equalPoint( rhs);
+			}
+	};
+	// struct VertexPointCompare
+	/**
+	 * An edge is a line between dots…
+	 */
+	struct Edge
+	{
+			Edge(	const Vertex& aVertex1,
+					const Vertex& aVertex2) :
+						vertex1( aVertex1),
+						vertex2( aVertex2)
+			{
+			}
+			Edge( const Edge& anEdge) :
+				vertex1( anEdge.vertex1),
+				vertex2( anEdge.vertex2)
+			{
+			}
+
+			const Vertex& thisSide( const Vertex& aVertex) const
+			{
+				if (vertex1.equalPoint( aVertex))
+					return vertex1;
+				if (vertex2.equalPoint( aVertex))
+					return vertex2;
+				throw std::logic_error( "thisSide: huh???");
+			}
+
+			const Vertex& otherSide( const Vertex& aVertex) const
+			{
+				if (vertex1.equalPoint( aVertex))
+					return vertex2;
+				if (vertex2.equalPoint( aVertex))
+					return vertex1;
+				throw std::logic_error( "otherSide: huh???");
+			}
+
+			Vertex vertex1;
+			Vertex vertex2;
+	}; // struct Edge
+	/**
+	 *
+	 * @param os
+	 * @param aVertex
+	 * @return
+	 */
+	inline std::ostream& operator<<( 	std::ostream& os,
+										const Vertex & aVertex)
+	{
+		return os << "(" << aVertex.x << "," << aVertex.y << "), " << aVertex.actualCost << " " << aVertex.heuristicCost;
+	}
+	/**
+	 *
+	 * @param os
+	 * @param anEdge
+	 * @return
+	 */
+	inline std::ostream& operator<<( 	std::ostream& os,
+										const Edge& anEdge)
+	{
+		return os << anEdge.vertex1 << " -> " << anEdge.vertex2;
+	}
+	/*
+	 *
+	 */
+	typedef std::vector< Vertex > Path;
+	typedef std::vector< Vertex > OpenSet;
+	typedef std::set< Vertex, VertexLessIdCompare > ClosedSet;
+	typedef std::map< Vertex, Vertex, VertexLessIdCompare > VertexMap;
+	/**
+	 * The interface of every path planner. A Robot holds a Planner and may be given another one at any time.
+	 * The open and closed sets are snapshots of the state of the last (or current) search for visualisation,
+	 * a planner that does not have such sets returns empty ones.
+	 */
+	class Planner : public Base::Notifier
+	{
+		public:
+			/**
+			 *
+			 */
+			Planner() :
+						expansions( 0),
+						cancelFlag( nullptr),
+						progressExpansionInterval( 0),
+						progressTimeInterval( 40),
+						unreportedExpansions( 0)
+			{
+			}
+			/**
+			 *
+			 */
+			virtual ~Planner() = default;
+			/**
+			 *
+			 */
+			virtual Path search(const wxPoint& aStartPoint,
+								const wxPoint& aGoalPoint,
+								const wxSize& aRobotSize) = 0;
+			/**
+			 * Like search but the path is written into aPath, so that a planner can reuse the memory of aPath
+			 *
+			 * @return false if there is no path, aPath is empty then
+			 */
+			virtual bool searchPath(const wxPoint& aStartPoint,
+									const wxPoint& aGoalPoint,
+									const wxSize& aRobotSize,
+									Path& aPath)
+			{
+				aPath = search( aStartPoint, aGoalPoint, aRobotSize);
+				return !aPath.empty();
+			}
+			/**
+			 *
+			 */
+			virtual OpenSet getOpenSet() const = 0;
+			/**
+			 *
+			 */
+			virtual ClosedSet getClosedSet() const = 0;
+			/**
+			 *
+			 * @return the number of vertices that were expanded by the last search
+			 */
+			std::size_t getExpansions() const
+			{
+				return expansions;
+			}
+			/**
+			 * @return true if the planner returned a path that is not the best it can find, in which case
+			 * searching again for the same goal improves the path (see AnytimeAStar)
+			 */
+			virtual bool isImprovable() const
+			{
+				return false;
+			}
+			/**
+			 * @return the number of steps of the RobotWorld for which a path of this planner keeps clear of the
+			 * reservations of the other robots, 0 if the planner ignores the other robots. A robot plans its path again
+			 * before half of the window has passed and reserves the window of every path it gets.
+			 */
+			virtual unsigned long getReservationWindow() const
+			{
+				return 0;
+			}
+			/**
+			 * @return a text that differs for planners that may find different paths for the same query: the type of
+			 * the planner followed by the settings that change its paths. The PathCache keeps a path per key.
+			 */
+			virtual std::string getCacheKey() const
+			{
+				return typeid( *this).name();
+			}
+			/**
+			 * Lets the following searches avoid the reservations of aReservationContext, an empty context restores the default.
+			 * Like the wall snapshot it is set by the PlanningService for the one search it runs.
+			 */
+			void setReservationContext( const ReservationContext& aReservationContext)
+			{
+				reservationContext = aReservationContext;
+			}
+			/**
+			 * The radius of the circle around a robot of the given size: a robot can turn within that circle
+			 */
+			static int getFreeRadius( const wxSize& aRobotSize)
+			{
+				return static_cast<int>(std::ceil(std::sqrt( ((aRobotSize.x+1) / 2.0) * ((aRobotSize.x+1) / 2.0) + ((aRobotSize.y+1) / 2.0) * ((aRobotSize.y+1) / 2.0))));
+			}
+			/**
+			 * Lets the following searches run against aWallSnapshot instead of the current walls of the RobotWorld,
+			 * which is what makes a search safe on another thread than the GUI thread. A null snapshot restores the default.
+			 */
+			void setWallSnapshot( const WallSnapshotPtr& aWallSnapshot)
+			{
+				wallSnapshot = aWallSnapshot;
+			}
+			/**
+			 * As soon as *aCancelFlag becomes true the running search stops at its next expansion without a path.
+			 * The flag is set by another thread and must outlive the search. A null flag never cancels.
+			 */
+			void setCancelFlag( const std::atomic< bool >* aCancelFlag)
+			{
+				cancelFlag = aCancelFlag;
+			}
+			/**
+			 * A search notifies its observers of its progress after every anExpansionInterval expansions or as soon as
+			 * aTimeInterval has passed since the last notification, whatever comes first, and once more when it is done.
+			 * 0 turns a bound off, with both off only the end of a search is notified. The default is every 40 ms.
+			 */
+			void setProgressInterval(	std::size_t anExpansionInterval,
+										std::chrono::milliseconds aTimeInterval)
+			{
+				progressExpansionInterval = anExpansionInterval;
+				progressTimeInterval = aTimeInterval;
+			}
+
+		protected:
+			/**
+			 * Checked by the planners once per expansion
+			 */
+			bool isCancelled() const
+			{
+				return cancelFlag != nullptr && cancelFlag->load( std::memory_order_relaxed);
+			}
+			/**
+			 * Called by the planners once per expansion instead of notifying the observers for every vertex that
+			 * changes, notifies them if one of the progress intervals has passed (see setProgressInterval)
+			 */
+			void reportProgress()
+			{
+				++unreportedExpansions;
+				if ((progressExpansionInterval != 0 && unreportedExpansions >= progressExpansionInterval) ||
+					(progressTimeInterval.count() != 0 && unreportedExpansions % progressClockInterval == 0 && isProgressIntervalPassed()))
+				{
+					publishProgress();
+				}
+			}
+			/**
+			 * Called by the planners at the start of every search, so that the progress intervals start with the search
+			 * instead of running on from the previous one
+			 */
+			void beginProgress();
+			/**
+			 * Notifies the observers and starts the next progress intervals, also called by the planners at the end of
+			 * a search
+			 */
+			void publishProgress();
+			/**
+			 * @return the snapshot given to setWallSnapshot or else the current snapshot of the RobotWorld
+			 */
+			WallSnapshotPtr getWallSnapshot() const;
+			/**
+			 *
+			 */
+			const ReservationContext& getReservationContext() const
+			{
+				return reservationContext;
+			}
+			/**
+			 * Reset at the start of every search, incremented by the planner for every vertex it expands
+			 */
+			std::size_t expansions;
+
+		private:
+			/**
+			 *
+			 */
+			WallSnapshotPtr wallSnapshot;
+			/**
+			 *
+			 */
+			const std::atomic< bool >* cancelFlag;
+			/**
+			 *
+			 */
+			ReservationContext reservationContext;
+			/**
+			 * Reading the clock is cheap but not free, so the time interval is checked every this many expansions
+			 */
+			static const std::size_t progressClockInterval = 64;
+			/**
+			 *
+			 */
+			bool isProgressIntervalPassed() const;
+			/**
+			 *
+			 */
+			std::size_t progressExpansionInterval;
+			/**
+			 *
+			 */
+			std::chrono::milliseconds progressTimeInterval;
+			/**
+			 * The expansions since the last notification
+			 */
+			std::size_t unreportedExpansions;
+			/**
+			 * The time of the last notification
+			 */
+			std::chrono::steady_clock::time_point lastProgress;
+	}; // class Planner
+	typedef std::shared_ptr< Planner > PlannerPtr;
+} // namespace PathAlgorithm
+#endif // PLANNER_HPP_
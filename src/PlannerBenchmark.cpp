@@ -0,0 +1,295 @@
+#include "PlannerBenchmark.hpp"
+
+#include "AllocationCounter.hpp"
+#include "AStar.hpp"
+#include "AnytimeAStar.hpp"
+#include "Goal.hpp"
+#include "PlannerFactory.hpp"
+#include "Robot.hpp"
+#include "RobotWorld.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <ostream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+namespace PathAlgorithm
+{
+	/**
+	 * RobotWorld::populate knows the cases 0 up to and including 10
+	 */
+	const int populateCases = 11;
+	/**
+	 * The size of the generated mazes: wide enough corridors for the default robot size
+	 */
+	const int mazeColumns = 8;
+	const int mazeRows = 8;
+	const int mazeCellSize = 80;
+	/**
+	 *
+	 */
+	double Percentile(	const std::vector< double >& someSortedValues,
+						double aPercentage)
+	{
+		std::size_t rank = static_cast< std::size_t >( std::ceil( aPercentage / 100.0 * static_cast< double >( someSortedValues.size())));
+		return someSortedValues[std::max( rank, static_cast< std::size_t >( 1)) - 1];
+	}
+	/**
+	 *
+	 * @return the peak resident set size of the process in kilobytes, 0 if the platform does not tell
+	 */
+	long MaxResidentSetKb()
+	{
+#if defined(__unix__) || defined(__APPLE__)
+		struct rusage usage;
+		if (getrusage( RUSAGE_SELF, &usage) == 0)
+		{
+#if defined(__APPLE__)
+			return usage.ru_maxrss / 1024;
+#else
+			return usage.ru_maxrss;
+#endif
+		}
+#endif
+		return 0;
+	}
+	/**
+	 *
+	 */
+	PlannerBenchmark::PlannerBenchmark() :
+							plannerNames( GetPlannerNames()),
+							runs( 10),
+							seed( 1),
+							mazeCount( 4),
+							robotSize( 37, 29)
+	{
+	}
+	/**
+	 *
+	 */
+	void PlannerBenchmark::run( std::ostream& anOutput)
+	{
+		Model::RobotWorld& robotWorld = Model::RobotWorld::getRobotWorld();
+
+		for (int worldCase = 0; worldCase < populateCases; ++worldCase)
+		{
+			robotWorld.unpopulate( false);
+			robotWorld.populate( worldCase);
+			runWorld( "populate-" + std::to_string( worldCase), anOutput);
+		}
+		for (unsigned long maze = 0; maze < mazeCount; ++maze)
+		{
+			PopulateMaze( seed + maze, mazeColumns, mazeRows, mazeCellSize);
+			runWorld( "maze-" + std::to_string( seed + maze), anOutput);
+		}
+
+		robotWorld.unpopulate( false);
+	}
+	/**
+	 *
+	 */
+	void PlannerBenchmark::runWorld(	const std::string& aWorldName,
+										std::ostream& anOutput)
+	{
+		Model::RobotWorld& robotWorld = Model::RobotWorld::getRobotWorld();
+		Model::RobotPtr robot = robotWorld.getRobot( "Robot");
+		Model::GoalPtr goal = robotWorld.getGoal( "Goal");
+		if (!robot || !goal)
+		{
+			throw std::runtime_error( "PlannerBenchmark: no Robot or Goal in " + aWorldName);
+		}
+		wxPoint start = robot->getPosition();
+		wxPoint goalPoint = goal->getPosition();
+
+		// The clearance map is shared by all planners, build it before any of them is timed
+		robotWorld.getClearanceMap();
+
+		std::vector< double > warmTimes;
+		warmTimes.reserve( runs);
+		for (const std::string& plannerName : plannerNames)
+		{
+			Base::AllocationCounter::resetPeakBytes();
+			std::size_t heapBefore = Base::AllocationCounter::getLiveBytes();
+
+			PlannerPtr planner = CreatePlanner( plannerName);
+			Path path;
+			bool found = false;
+			double coldTime = 0.0;
+			std::size_t coldAllocations = 0;
+			std::size_t warmAllocations = 0;
+
+			warmTimes.clear();
+			for (unsigned long run = 0; run < runs; ++run)
+			{
+				std::size_t allocationsBefore = Base::AllocationCounter::getAllocations();
+				std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+				found = planner->searchPath( start, goalPoint, robotSize, path);
+				std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+				std::size_t allocations = Base::AllocationCounter::getAllocations() - allocationsBefore;
+
+				double time = std::chrono::duration< double, std::micro >( end - begin).count();
+				if (run == 0)
+				{
+					coldTime = time;
+					coldAllocations = allocations;
+				} else
+				{
+					warmTimes.push_back( time);
+					warmAllocations = std::max( warmAllocations, allocations);
+				}
+			}
+			if (warmTimes.empty())
+			{
+				warmTimes.push_back( coldTime);
+			}
+			std::sort( warmTimes.begin(), warmTimes.end());
+
+			std::size_t peakBytes = Base::AllocationCounter::getPeakBytes();
+			peakBytes = peakBytes > heapBefore ? peakBytes - heapBefore : 0;
+
+			std::ostringstream os;
+			os << std::fixed << std::setprecision( 2);
+			os << "{\"world\":\"" << aWorldName << "\""
+			   << ",\"planner\":\"" << plannerName << "\""
+			   << ",\"runs\":" << runs
+			   << ",\"found\":" << (found ? "true" : "false")
+			   << ",\"path_vertices\":" << path.size()
+			   << ",\"path_cost\":" << (path.empty() ? 0.0 : path.back().actualCost)
+			   << ",\"expansions\":" << planner->getExpansions();
+			if (const AStar* aStar = dynamic_cast< const AStar* >( planner.get()))
+			{
+				os << ",\"expansions_forward\":" << aStar->getForwardExpansions()
+				   << ",\"expansions_backward\":" << aStar->getBackwardExpansions()
+				   << ",\"meet\":[" << aStar->getMeetPoint().x << "," << aStar->getMeetPoint().y << "]";
+			}
+			if (const AnytimeAStar* anytimeAStar = dynamic_cast< const AnytimeAStar* >( planner.get()))
+			{
+				// JSON has no infinity
+				double bound = anytimeAStar->getSuboptimalityBound();
+				os << ",\"suboptimality\":";
+				if (std::isinf( bound))
+				{
+					os << "null";
+				} else
+				{
+					os << bound;
+				}
+			}
+			os << ",\"cold_us\":" << coldTime
+			   << ",\"p50_us\":" << Percentile( warmTimes, 50.0)
+			   << ",\"p90_us\":" << Percentile( warmTimes, 90.0)
+			   << ",\"p99_us\":" << Percentile( warmTimes, 99.0)
+			   << ",\"max_us\":" << warmTimes.back()
+			   << ",\"allocations_cold\":" << coldAllocations
+			   << ",\"allocations_warm\":" << warmAllocations
+			   << ",\"peak_heap_bytes\":" << peakBytes
+			   << ",\"max_rss_kb\":" << MaxResidentSetKb()
+			   << "}";
+			anOutput << os.str() << std::endl;
+		}
+	}
+	/**
+	 *
+	 */
+	void PopulateMaze(	unsigned long aSeed,
+						int aColumns,
+						int aRows,
+						int aCellSize)
+	{
+		// Same origin as the walls of RobotWorld::populate
+		const int origin = 5;
+
+		// std::mt19937 gives the same sequence everywhere, the standard distributions do not
+		std::mt19937 generator( static_cast< std::mt19937::result_type >( aSeed));
+
+		std::size_t cellCount = static_cast< std::size_t >( aColumns * aRows);
+		std::vector< bool > visited( cellCount, false);
+		std::vector< bool > openEast( cellCount, false);
+		std::vector< bool > openSouth( cellCount, false);
+
+		std::vector< int > stack( 1, 0);
+		visited[0] = true;
+		while (!stack.empty())
+		{
+			int cell = stack.back();
+			int x = cell % aColumns;
+			int y = cell / aColumns;
+
+			int neighbours[4];
+			int neighbourCount = 0;
+			if (x > 0 && !visited[cell - 1])
+			{
+				neighbours[neighbourCount++] = cell - 1;
+			}
+			if (x < aColumns - 1 && !visited[cell + 1])
+			{
+				neighbours[neighbourCount++] = cell + 1;
+			}
+			if (y > 0 && !visited[cell - aColumns])
+			{
+				neighbours[neighbourCount++] = cell - aColumns;
+			}
+			if (y < aRows - 1 && !visited[cell + aColumns])
+			{
+				neighbours[neighbourCount++] = cell + aColumns;
+			}
+			if (neighbourCount == 0)
+			{
+				stack.pop_back();
+				continue;
+			}
+
+			int next = neighbours[generator() % static_cast< unsigned int >( neighbourCount)];
+			if (next == cell + 1 || next == cell - 1)
+			{
+				openEast[std::min( cell, next)] = true;
+			} else
+			{
+				openSouth[std::min( cell, next)] = true;
+			}
+			visited[next] = true;
+			stack.push_back( next);
+		}
+
+		Model::RobotWorld& robotWorld = Model::RobotWorld::getRobotWorld();
+		robotWorld.unpopulate( false);
+
+		int right = origin + aColumns * aCellSize;
+		int bottom = origin + aRows * aCellSize;
+		robotWorld.newWall( wxPoint( origin, origin), wxPoint( right, origin), false);
+		robotWorld.newWall( wxPoint( right, origin), wxPoint( right, bottom), false);
+		robotWorld.newWall( wxPoint( right, bottom), wxPoint( origin, bottom), false);
+		robotWorld.newWall( wxPoint( origin, bottom), wxPoint( origin, origin), false);
+
+		for (int y = 0; y < aRows; ++y)
+		{
+			for (int x = 0; x < aColumns; ++x)
+			{
+				std::size_t cell = static_cast< std::size_t >( y * aColumns + x);
+				int left = origin + x * aCellSize;
+				int top = origin + y * aCellSize;
+				if (x < aColumns - 1 && !openEast[cell])
+				{
+					robotWorld.newWall( wxPoint( left + aCellSize, top), wxPoint( left + aCellSize, top + aCellSize), false);
+				}
+				if (y < aRows - 1 && !openSouth[cell])
+				{
+					robotWorld.newWall( wxPoint( left, top + aCellSize), wxPoint( left + aCellSize, top + aCellSize), false);
+				}
+			}
+		}
+
+		robotWorld.newRobot( "Robot", wxPoint( origin + aCellSize / 2, origin + aCellSize / 2), false);
+		robotWorld.newGoal( "Goal", wxPoint( right - aCellSize / 2, bottom - aCellSize / 2), false);
+
+		robotWorld.notifyObservers();
+	}
+} // namespace PathAlgorithm
@@ -0,0 +1,120 @@
+#ifndef PLANNERBENCHMARK_HPP_
+#define PLANNERBENCHMARK_HPP_
+
+#include "Config.hpp"
+
+#include "Point.hpp"
+#include "Size.hpp"
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace PathAlgorithm
+{
+	/**
+	 * Runs planners over every RobotWorld::populate case and over random mazes, without any window.
+	 *
+	 * Every planner is created with CreatePlanner for every world and searches the same route a number of times.
+	 * The first search is the cold one: it includes the preprocessing of the planner. The percentiles are over the
+	 * other (warm) searches. The result is one JSON object per line for every world and planner:
+	 *
+	 * {"world":"maze-1","planner":"jps","runs":5,"found":true,"path_vertices":1721,"path_cost":1968.53,"expansions":188,
+	 *  "cold_us":8622.10,"p50_us":3272.49,"p90_us":3399.16,"p99_us":3399.16,"max_us":3399.16,
+	 *  "allocations_cold":23,"allocations_warm":0,"peak_heap_bytes":12324366,"max_rss_kb":21300}
+	 *
+	 * allocations_warm is the maximum over the warm searches, peak_heap_bytes the peak of the heap while the planner
+	 * existed minus the heap before it was created and max_rss_kb the peak resident set of the whole process so far.
+	 */
+	class PlannerBenchmark
+	{
+		public:
+			/**
+			 * All planners, 10 searches per planner and world, 4 mazes starting at seed 1, a 37x29 robot
+			 */
+			PlannerBenchmark();
+			/**
+			 *
+			 */
+			void setPlanners( const std::vector< std::string >& aPlannerNames)
+			{
+				plannerNames = aPlannerNames;
+			}
+			/**
+			 *
+			 */
+			void setRuns( unsigned long aRuns)
+			{
+				runs = aRuns;
+			}
+			/**
+			 * Maze i is generated with seed aSeed + i
+			 */
+			void setSeed( unsigned long aSeed)
+			{
+				seed = aSeed;
+			}
+			/**
+			 *
+			 */
+			void setMazeCount( unsigned long aMazeCount)
+			{
+				mazeCount = aMazeCount;
+			}
+			/**
+			 *
+			 */
+			void setRobotSize( const wxSize& aRobotSize)
+			{
+				robotSize = aRobotSize;
+			}
+			/**
+			 * Replaces the contents of the RobotWorld by every world in turn and writes the results to anOutput
+			 */
+			void run( std::ostream& anOutput);
+
+		private:
+			/**
+			 * Runs every planner from the robot "Robot" to the goal "Goal" in the current RobotWorld
+			 */
+			void runWorld(	const std::string& aWorldName,
+							std::ostream& anOutput);
+			/**
+			 *
+			 */
+			std::vector< std::string > plannerNames;
+			/**
+			 *
+			 */
+			unsigned long runs;
+			/**
+			 *
+			 */
+			unsigned long seed;
+			/**
+			 *
+			 */
+			unsigned long mazeCount;
+			/**
+			 *
+			 */
+			wxSize robotSize;
+	};
+	// class PlannerBenchmark
+
+	/**
+	 * The nearest-rank percentile (0 < aPercentage <= 100) of the sorted values, which must not be empty
+	 */
+	double Percentile(	const std::vector< double >& someSortedValues,
+						double aPercentage);
+	/**
+	 * Replaces the contents of the RobotWorld with a perfect maze (exactly one route between any two cells) of
+	 * aColumns by aRows cells of aCellSize pixels, generated by a randomised depth first search seeded with aSeed.
+	 * The robot "Robot" is put in the centre of the top left cell and the goal "Goal" in the centre of the bottom right one.
+	 */
+	void PopulateMaze(	unsigned long aSeed,
+						int aColumns,
+						int aRows,
+						int aCellSize);
+} // namespace PathAlgorithm
+#endif // PLANNERBENCHMARK_HPP_
@@ -0,0 +1,84 @@
+#include "PlannerFactory.hpp"
+
+#include "AStar.hpp"
+#include "AnytimeAStar.hpp"
+#include "CooperativeAStar.hpp"
+#include "DStarLite.hpp"
+#include "GridAStar.hpp"
+#include "HierarchicalAStar.hpp"
+#include "JumpPointSearch.hpp"
+#include "VisibilityGraph.hpp"
+
+#include <stdexcept>
+
+namespace PathAlgorithm
+{
+	/**
+	 *
+	 */
+	PlannerPtr CreatePlanner( const std::string& aName)
+	{
+		if (aName == "astar")
+		{
+			return std::make_shared< AStar >();
+		}
+		if (aName == "bidirectional")
+		{
+			std::shared_ptr< AStar > planner = std::make_shared< AStar >();
+			planner->setSearchDirection( AStar::Bidirectional);
+			return planner;
+		}
+		if (aName == "astar-octile8")
+		{
+			return std::make_shared< GridAStar< OctileHeuristic, EightConnected > >();
+		}
+		if (aName == "astar-euclidean8")
+		{
+			return std::make_shared< GridAStar< EuclideanHeuristic, EightConnected > >();
+		}
+		if (aName == "astar-weighted8")
+		{
+			return std::make_shared< GridAStar< WeightedHeuristic< OctileHeuristic, 3, 2 >, EightConnected > >();
+		}
+		if (aName == "astar-manhattan4")
+		{
+			return std::make_shared< GridAStar< ManhattanHeuristic, FourConnected > >();
+		}
+		if (aName == "astar-euclidean16")
+		{
+			return std::make_shared< GridAStar< EuclideanHeuristic, SixteenConnected > >();
+		}
+		if (aName == "jps")
+		{
+			return std::make_shared< JumpPointSearch >();
+		}
+		if (aName == "visibility")
+		{
+			return std::make_shared< VisibilityGraph >();
+		}
+		if (aName == "dstarlite")
+		{
+			return std::make_shared< DStarLite >();
+		}
+		if (aName == "hpa")
+		{
+			return std::make_shared< HierarchicalAStar >();
+		}
+		if (aName == "arastar")
+		{
+			return std::make_shared< AnytimeAStar >();
+		}
+		if (aName == "whca")
+		{
+			return std::make_shared< CooperativeAStar >();
+		}
+		throw std::invalid_argument( "CreatePlanner: unknown planner " + aName);
+	}
+	/**
+	 *
+	 */
+	std::vector< std::string > GetPlannerNames()
+	{
+		return { "astar", "bidirectional", "astar-octile8", "astar-euclidean8", "astar-weighted8", "astar-manhattan4", "astar-euclidean16", "jps", "visibility", "dstarlite", "hpa", "arastar", "whca"};
+	}
+} // namespace PathAlgorithm
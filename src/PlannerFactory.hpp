@@ -0,0 +1,29 @@
+#ifndef PLANNERFACTORY_HPP_
+#define PLANNERFACTORY_HPP_
+
+#include "Config.hpp"
+
+#include "Planner.hpp"
+
+#include <string>
+#include <vector>
+
+namespace PathAlgorithm
+{
+	/**
+	 * Creates a planner by name: "astar", "bidirectional" (AStar searching Bidirectional), "jps" (JumpPointSearch),
+	 * "astar-octile8", "astar-euclidean8", "astar-weighted8" (octile times 1.5), "astar-manhattan4" and "astar-euclidean16"
+	 * (GridAStar with the named heuristic and connectivity),
+	 * "visibility" (VisibilityGraph), "dstarlite" (DStarLite), "hpa" (HierarchicalAStar), "arastar" (AnytimeAStar)
+	 * or "whca" (CooperativeAStar).
+	 *
+	 * @throws std::invalid_argument if there is no planner with that name
+	 */
+	PlannerPtr CreatePlanner( const std::string& aName);
+	/**
+	 *
+	 * @return the names that CreatePlanner accepts
+	 */
+	std::vector< std::string > GetPlannerNames();
+} // namespace PathAlgorithm
+#endif // PLANNERFACTORY_HPP_
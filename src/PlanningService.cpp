@@ -0,0 +1,218 @@
+#include "PlanningService.hpp"
+
+#include "PathCache.hpp"
+#include "PathSmoothing.hpp"
+#include "RobotWorld.hpp"
+
+#include <algorithm>
+#include <exception>
+#include <iostream>
+#include <utility>
+
+namespace PathAlgorithm
+{
+	/**
+	 *
+	 */
+	/* static */PlanningService& PlanningService::getPlanningService()
+	{
+		// The workers fill the path cache until they have stopped, so the cache must be there first
+		PathCache::getPathCache();
+		static PlanningService planningService;
+		return planningService;
+	}
+	/**
+	 *
+	 */
+	PlanningService::PlanningService() :
+								stopping( false)
+	{
+		unsigned int threadCount = std::max( std::thread::hardware_concurrency(), 1U);
+		for (unsigned int i = 0; i < threadCount; ++i)
+		{
+			threads.push_back( std::thread( &PlanningService::work, this));
+		}
+	}
+	/**
+	 *
+	 */
+	PlanningService::~PlanningService()
+	{
+		{
+			std::lock_guard< std::mutex > guard( requestsMutex);
+			stopping = true;
+			queuedRequests.clear();
+		}
+		requestQueued.notify_all();
+		for (std::thread& thread : threads)
+		{
+			thread.join();
+		}
+	}
+	/**
+	 *
+	 */
+	PathRequestPtr PlanningService::requestPath(	const PlannerPtr& aPlanner,
+												const wxPoint& aStartPoint,
+												const wxPoint& aGoalPoint,
+												const wxSize& aRobotSize,
+												const PathHandler& aPathHandler,
+												const ReservationContext& aReservationContext /*= ReservationContext()*/)
+	{
+		PathRequestPtr handle = std::make_shared< PathRequest >();
+
+		Request request;
+		request.handle = handle;
+		request.planner = aPlanner;
+		request.wallSnapshot = Model::RobotWorld::getRobotWorld().getWallSnapshot();
+		request.reservationContext = aReservationContext;
+		request.startPoint = aStartPoint;
+		request.goalPoint = aGoalPoint;
+		request.robotSize = aRobotSize;
+		request.pathHandler = aPathHandler;
+
+		// A path that was found before for the same walls is delivered without a search
+		if (isCacheable( request) && PathCache::getPathCache().find( *aPlanner, request.wallSnapshot->getWallsHash(), aStartPoint, aGoalPoint, aRobotSize, request.path))
+		{
+			std::lock_guard< std::mutex > guard( requestsMutex);
+			finishedRequests.push_back( std::move( request));
+			return handle;
+		}
+
+		{
+			std::lock_guard< std::mutex > guard( requestsMutex);
+			queuedRequests.push_back( std::move( request));
+		}
+		requestQueued.notify_one();
+
+		return handle;
+	}
+	/**
+	 *
+	 */
+	std::size_t PlanningService::deliverPaths()
+	{
+		std::vector< Request > requests;
+		{
+			std::lock_guard< std::mutex > guard( requestsMutex);
+			requests.swap( finishedRequests);
+		}
+		// The handlers run without the lock, they may request a new path
+		std::size_t delivered = 0;
+		for (const Request& request : requests)
+		{
+			if (!request.handle->isCancelled())
+			{
+				request.pathHandler( request.path);
+				++delivered;
+			}
+		}
+		return delivered;
+	}
+	/**
+	 *
+	 */
+	std::size_t PlanningService::getPendingCount() const
+	{
+		std::lock_guard< std::mutex > guard( requestsMutex);
+		return queuedRequests.size() + busyPlanners.size() + finishedRequests.size();
+	}
+	/**
+	 *
+	 */
+	bool PlanningService::isPlannerBusy( const Planner& aPlanner) const
+	{
+		std::lock_guard< std::mutex > guard( requestsMutex);
+		if (busyPlanners.find( &aPlanner) != busyPlanners.end())
+		{
+			return true;
+		}
+		return std::any_of( queuedRequests.begin(), queuedRequests.end(), [&aPlanner](const Request& aRequest)
+		{
+			return aRequest.planner.get() == &aPlanner && !aRequest.handle->isCancelled();
+		});
+	}
+	/**
+	 *
+	 */
+	void PlanningService::work()
+	{
+		std::unique_lock< std::mutex > lock( requestsMutex);
+		while (true)
+		{
+			// The oldest request whose planner is not being searched by another worker
+			std::deque< Request >::iterator next = queuedRequests.end();
+			requestQueued.wait( lock, [this, &next]
+			{
+				queuedRequests.erase( std::remove_if( queuedRequests.begin(), queuedRequests.end(), [](const Request& aRequest)
+				{
+					return aRequest.handle->isCancelled();
+				}), queuedRequests.end());
+
+				next = std::find_if( queuedRequests.begin(), queuedRequests.end(), [this](const Request& aRequest)
+				{
+					return busyPlanners.find( aRequest.planner.get()) == busyPlanners.end();
+				});
+				return stopping || next != queuedRequests.end();
+			});
+			if (stopping)
+			{
+				return;
+			}
+
+			Request request = std::move( *next);
+			queuedRequests.erase( next);
+			busyPlanners.insert( request.planner.get());
+			lock.unlock();
+
+			try
+			{
+				request.planner->setWallSnapshot( request.wallSnapshot);
+				request.planner->setCancelFlag( &request.handle->cancelled);
+				request.planner->setReservationContext( request.reservationContext);
+				if (request.planner->searchPath( request.startPoint, request.goalPoint, request.robotSize, request.path))
+				{
+					// The timed window of a cooperative path has to stay as it is
+					std::size_t firstVertex = request.planner->getReservationWindow() * std::max( request.reservationContext.stepLength, 1U);
+					SmoothPath( request.path, Planner::getFreeRadius( request.robotSize), request.wallSnapshot->getWalls(), firstVertex);
+
+					if (isCacheable( request) && !request.planner->isImprovable() && !request.handle->isCancelled())
+					{
+						PathCache::getPathCache().insert( *request.planner, request.wallSnapshot->getWallsHash(), request.startPoint, request.goalPoint, request.robotSize, request.path);
+					}
+				}
+			}
+			catch (std::exception& e)
+			{
+				std::cerr << __PRETTY_FUNCTION__ << ": " << e.what() << std::endl;
+				request.path.clear();
+			}
+			catch (...)
+			{
+				std::cerr << __PRETTY_FUNCTION__ << ": unknown exception" << std::endl;
+				request.path.clear();
+			}
+			request.planner->setWallSnapshot( WallSnapshotPtr());
+			request.planner->setCancelFlag( nullptr);
+			request.planner->setReservationContext( ReservationContext());
+
+			lock.lock();
+			busyPlanners.erase( request.planner.get());
+			if (!request.handle->isCancelled())
+			{
+				finishedRequests.push_back( std::move( request));
+			}
+
+			// A request that waited for this planner may run now
+			requestQueued.notify_all();
+		}
+	}
+	/**
+	 *
+	 */
+	/* static */bool PlanningService::isCacheable( const Request& aRequest)
+	{
+		// A path around the reservations of the other robots is only valid for the moment it was searched
+		return !aRequest.reservationContext.reservationTable || aRequest.reservationContext.reservationTable->empty();
+	}
+} // namespace PathAlgorithm
@@ -0,0 +1,190 @@
+#ifndef PLANNINGSERVICE_HPP_
+#define PLANNINGSERVICE_HPP_
+
+#include "Config.hpp"
+
+#include "Planner.hpp"
+#include "Point.hpp"
+#include "ReservationTable.hpp"
+#include "Size.hpp"
+#include "WallSnapshot.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace PathAlgorithm
+{
+	class PlanningService;
+
+	/**
+	 * The handle of a path that was requested from the PlanningService
+	 */
+	class PathRequest
+	{
+		public:
+			/**
+			 *
+			 */
+			PathRequest() :
+							cancelled( false)
+			{
+			}
+			/**
+			 * A queued request is dropped, a running search stops at its next expansion and a finished path is not
+			 * delivered. If cancel is called on the GUI thread the path handler is never called afterwards.
+			 */
+			void cancel()
+			{
+				cancelled.store( true);
+			}
+			/**
+			 *
+			 */
+			bool isCancelled() const
+			{
+				return cancelled.load();
+			}
+
+		private:
+			friend class PlanningService;
+			/**
+			 *
+			 */
+			std::atomic< bool > cancelled;
+	};
+	// class PathRequest
+	typedef std::shared_ptr< PathRequest > PathRequestPtr;
+
+	/**
+	 * Runs path searches for any number of robots on a fixed pool of worker threads.
+	 *
+	 * A request is made on the GUI thread: it takes the current WallSnapshot of the RobotWorld, so the search runs
+	 * against the walls as they were at the request, whatever happens to the walls while it runs. The paths are
+	 * handed back on the GUI thread as well, by deliverPaths, which RobotWorld::step calls on every step.
+	 *
+	 * A planner is never searched by two threads at once: a request waits while an earlier request for the
+	 * same planner runs. Requests for different planners run in parallel. A request that is superseded by a newer
+	 * one should be cancelled through its PathRequest, so the planner is free for the newer one as soon as possible.
+	 *
+	 * A path is string-pulled (see SmoothPath) before it is delivered. A path that only depends on the walls is kept
+	 * in the PathCache, the same request for the same walls gets it on the next call of deliverPaths without a search.
+	 */
+	class PlanningService
+	{
+		public:
+			/**
+			 * Called on the GUI thread with the path of a request, the path is empty if there is no route
+			 */
+			typedef std::function< void ( const Path& aPath) > PathHandler;
+			/**
+			 *
+			 */
+			static PlanningService& getPlanningService();
+			/**
+			 * Queues a search with aPlanner from aStartPoint to aGoalPoint. aPathHandler is called by deliverPaths
+			 * once the search has finished, unless the request is cancelled first. Must be called on the GUI thread.
+			 * A cooperative planner avoids the reservations of aReservationContext.
+			 */
+			PathRequestPtr requestPath(	const PlannerPtr& aPlanner,
+										const wxPoint& aStartPoint,
+										const wxPoint& aGoalPoint,
+										const wxSize& aRobotSize,
+										const PathHandler& aPathHandler,
+										const ReservationContext& aReservationContext = ReservationContext());
+			/**
+			 * Calls the path handlers of all searches that finished since the previous call, in the order in which
+			 * they finished. Must be called on the GUI thread.
+			 *
+			 * @return the number of delivered paths
+			 */
+			std::size_t deliverPaths();
+			/**
+			 * @return the number of requests that are queued, running or waiting to be delivered
+			 */
+			std::size_t getPendingCount() const;
+			/**
+			 * @return true if aPlanner is being searched by a worker or will be by a request that is queued and not
+			 * cancelled. A cancelled search keeps its planner busy until it has stopped. If it returns false on the
+			 * GUI thread, the planner may be read there until the next request for it.
+			 */
+			bool isPlannerBusy( const Planner& aPlanner) const;
+			/**
+			 *
+			 */
+			std::size_t getThreadCount() const
+			{
+				return threads.size();
+			}
+
+		private:
+			/**
+			 *
+			 */
+			struct Request
+			{
+					PathRequestPtr handle;
+					PlannerPtr planner;
+					WallSnapshotPtr wallSnapshot;
+					ReservationContext reservationContext;
+					wxPoint startPoint;
+					wxPoint goalPoint;
+					wxSize robotSize;
+					PathHandler pathHandler;
+					Path path;
+			};
+			/**
+			 * One worker thread per hardware thread
+			 */
+			PlanningService();
+			/**
+			 * Stops the workers after their current search, queued requests are dropped
+			 */
+			~PlanningService();
+			/**
+			 * The loop of a worker thread
+			 */
+			void work();
+			/**
+			 * @return true if the path of aRequest only depends on the walls, the start, the goal and the size of the robot
+			 */
+			static bool isCacheable( const Request& aRequest);
+			/**
+			 *
+			 */
+			std::vector< std::thread > threads;
+			/**
+			 * Guards everything below
+			 */
+			mutable std::mutex requestsMutex;
+			/**
+			 *
+			 */
+			std::condition_variable requestQueued;
+			/**
+			 *
+			 */
+			std::deque< Request > queuedRequests;
+			/**
+			 * The planners that are being searched by a worker
+			 */
+			std::set< const Planner* > busyPlanners;
+			/**
+			 *
+			 */
+			std::vector< Request > finishedRequests;
+			/**
+			 *
+			 */
+			bool stopping;
+	};
+	// class PlanningService
+} // namespace PathAlgorithm
+#endif // PLANNINGSERVICE_HPP_
@@ -0,0 +1,162 @@
+#include "ReservationTable.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace PathAlgorithm
+{
+	/**
+	 *
+	 */
+	ReservationTable::ReservationTable( int aCellSize /*= 64*/) :
+								cellSize( aCellSize),
+								maximumRadius( 0),
+								version( 0)
+	{
+		if (cellSize <= 0)
+		{
+			throw std::invalid_argument( "ReservationTable: the cell size must be more than 0");
+		}
+	}
+	/**
+	 *
+	 */
+	bool ReservationTable::reserve(	const Base::ObjectId& aRobot,
+									unsigned long aFirstStep,
+									const std::vector< wxPoint >& aTrajectory,
+									int aRadius)
+	{
+		release( aRobot);
+
+		bool free = true;
+		for (std::size_t i = 0; i < aTrajectory.size(); ++i)
+		{
+			free = free && isFree( aTrajectory[i], aRadius, aFirstStep + i, aRobot);
+			cells[key( cellOf( aTrajectory[i].x), cellOf( aTrajectory[i].y), aFirstStep + i)].push_back( Reservation{ aRobot, aTrajectory[i], aRadius});
+		}
+		maximumRadius = std::max( maximumRadius, aRadius);
+		++version;
+
+		return free;
+	}
+	/**
+	 *
+	 */
+	void ReservationTable::release( const Base::ObjectId& aRobot)
+	{
+		bool released = false;
+		for (auto i = cells.begin(); i != cells.end();)
+		{
+			std::vector< Reservation >& reservations = i->second;
+			std::size_t size = reservations.size();
+			reservations.erase( std::remove_if( reservations.begin(), reservations.end(), [&aRobot](const Reservation& aReservation)
+			{
+				return aReservation.robot == aRobot;
+			}), reservations.end());
+			released = released || reservations.size() != size;
+
+			if (reservations.empty())
+			{
+				i = cells.erase( i);
+			} else
+			{
+				++i;
+			}
+		}
+		if (released)
+		{
+			++version;
+		}
+	}
+	/**
+	 *
+	 */
+	void ReservationTable::releaseBefore( unsigned long aStep)
+	{
+		bool released = false;
+		for (auto i = cells.begin(); i != cells.end();)
+		{
+			if (stepOf( i->first) < aStep)
+			{
+				i = cells.erase( i);
+				released = true;
+			} else
+			{
+				++i;
+			}
+		}
+		if (released)
+		{
+			++version;
+		}
+	}
+	/**
+	 *
+	 */
+	bool ReservationTable::isFree(	const wxPoint& aPoint,
+									int aRadius,
+									unsigned long aStep,
+									const Base::ObjectId& aRobot) const
+	{
+		if (cells.empty())
+		{
+			return true;
+		}
+
+		// A reservation in a cell further away than this cannot overlap
+		int reach = aRadius + maximumRadius;
+		for (int cellX = cellOf( aPoint.x - reach); cellX <= cellOf( aPoint.x + reach); ++cellX)
+		{
+			for (int cellY = cellOf( aPoint.y - reach); cellY <= cellOf( aPoint.y + reach); ++cellY)
+			{
+				auto i = cells.find( key( cellX, cellY, aStep));
+				if (i == cells.end())
+				{
+					continue;
+				}
+				for (const Reservation& reservation : i->second)
+				{
+					if (reservation.robot == aRobot)
+					{
+						continue;
+					}
+					long long dx = reservation.point.x - aPoint.x;
+					long long dy = reservation.point.y - aPoint.y;
+					long long distance = aRadius + reservation.radius;
+					if (dx * dx + dy * dy < distance * distance)
+					{
+						return false;
+					}
+				}
+			}
+		}
+		return true;
+	}
+	/**
+	 *
+	 */
+	/* static */std::uint64_t ReservationTable::key(	int aCellX,
+													int aCellY,
+													unsigned long aStep)
+	{
+		// 16 bits per cell coordinate: 65536 cells per axis, centred around 0
+		return (static_cast< std::uint64_t >( aStep & 0xFFFFFFFFUL) << 32) |
+				(static_cast< std::uint64_t >( (aCellX + 0x8000) & 0xFFFF) << 16) |
+				static_cast< std::uint64_t >( (aCellY + 0x8000) & 0xFFFF);
+	}
+	/**
+	 *
+	 */
+	/* static */unsigned long ReservationTable::stepOf( std::uint64_t aKey)
+	{
+		return static_cast< unsigned long >( aKey >> 32);
+	}
+	/**
+	 *
+	 */
+	int ReservationTable::cellOf( int aCoordinate) const
+	{
+		// Rounds towards minus infinity, also for negative coordinates
+		return aCoordinate >= 0 ? aCoordinate / cellSize : -((cellSize - 1 - aCoordinate) / cellSize);
+	}
+} // namespace PathAlgorithm
@@ -0,0 +1,126 @@
+#ifndef RESERVATIONTABLE_HPP_
+#define RESERVATIONTABLE_HPP_
+
+#include "Config.hpp"
+
+#include "ObjectId.hpp"
+#include "Point.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace PathAlgorithm
+{
+	/**
+	 * A space-time reservation table: for every step of the RobotWorld the circles that the robots will cover.
+	 *
+	 * A robot reserves the trajectory of its current path, a cooperative planner (see CooperativeAStar) plans
+	 * around the reservations of the other robots. Space is divided into square cells, a reservation is kept in the
+	 * cell of its centre at its step, so a lookup only visits the few cells around the point it asks for.
+	 */
+	class ReservationTable
+	{
+		public:
+			/**
+			 * @param aCellSize the side of a cell in pixels, about the diameter of a robot is best
+			 */
+			explicit ReservationTable( int aCellSize = 64);
+			/**
+			 * Replaces the reservations of aRobot: at step aFirstStep + i it covers the circle with aRadius around aTrajectory[i]
+			 *
+			 * @return false if a reservation overlaps one of another robot, it is made anyway
+			 */
+			bool reserve(	const Base::ObjectId& aRobot,
+							unsigned long aFirstStep,
+							const std::vector< wxPoint >& aTrajectory,
+							int aRadius);
+			/**
+			 * Removes all reservations of aRobot
+			 */
+			void release( const Base::ObjectId& aRobot);
+			/**
+			 * Removes all reservations for the steps before aStep
+			 */
+			void releaseBefore( unsigned long aStep);
+			/**
+			 * @return true if the circle with aRadius around aPoint does not overlap a reservation of a robot other than aRobot at aStep
+			 */
+			bool isFree(	const wxPoint& aPoint,
+							int aRadius,
+							unsigned long aStep,
+							const Base::ObjectId& aRobot) const;
+			/**
+			 * @return true if there are no reservations at all
+			 */
+			bool empty() const
+			{
+				return cells.empty();
+			}
+			/**
+			 * @return a number that changes every time a reservation is made or removed
+			 */
+			unsigned long getVersion() const
+			{
+				return version;
+			}
+
+		private:
+			/**
+			 *
+			 */
+			struct Reservation
+			{
+					Base::ObjectId robot;
+					wxPoint point;
+					int radius;
+			};
+			/**
+			 * The cell coordinates and the step packed in one key
+			 */
+			static std::uint64_t key(	int aCellX,
+										int aCellY,
+										unsigned long aStep);
+			/**
+			 *
+			 */
+			static unsigned long stepOf( std::uint64_t aKey);
+			/**
+			 *
+			 */
+			int cellOf( int aCoordinate) const;
+			/**
+			 *
+			 */
+			int cellSize;
+			/**
+			 * The largest radius of all reservations, it determines how many cells a lookup must visit
+			 */
+			int maximumRadius;
+			/**
+			 *
+			 */
+			std::unordered_map< std::uint64_t, std::vector< Reservation > > cells;
+			/**
+			 *
+			 */
+			unsigned long version;
+	}; // class ReservationTable
+	typedef std::shared_ptr< const ReservationTable > ReservationTablePtr;
+
+	/**
+	 * What a cooperative search needs to know about the robot it plans for: the reservations of the RobotWorld, the
+	 * robot whose own reservations do not count, the step of the RobotWorld at which the robot is at the start point and the
+	 * number of pixels the robot moves per step. A context without a table lets every planner ignore the other robots.
+	 */
+	struct ReservationContext
+	{
+			ReservationTablePtr reservationTable;
+			Base::ObjectId robot;
+			unsigned long firstStep = 0;
+			unsigned int stepLength = 1;
+	};
+	// struct ReservationContext
+} // namespace PathAlgorithm
+#endif // RESERVATIONTABLE_HPP_
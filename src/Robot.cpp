@@ -2,12 +2,14 @@
 
 #include "Client.hpp"
 #include "CommunicationService.hpp"
+#include "CooperativeAStar.hpp"
 #include "Goal.hpp"
 #include "Logger.hpp"
 #include "MainApplication.hpp"
 #include "MathUtils.hpp"
 #include "Message.hpp"
 #include "MessageTypes.hpp"
+#include "PlannerFactory.hpp"
 #include "RobotWorld.hpp"
 #include "Server.hpp"
 #include "Shape2DUtils.hpp"
@@ -16,7 +18,10 @@
 #include "SyncWallMessage.hpp"
 #include "SyncRobotMessage.h"
 
+#include <algorithm>
 #include <chrono>
+#include <cmath>
+#include <cstdlib>
 #include <ctime>
 #include <sstream>
 #include <thread>
@@ -44,11 +49,19 @@ namespace Model {
             position(aPosition),
             front(0, 0),
             speed(0.0),
+            planner(std::make_shared<PathAlgorithm::CooperativeAStar>()),
             acting(false),
             driving(false),
             communicating(false) {
         // We use the real position for starters, not an estimated position.
         startPosition = position;
+        updateCorners();
+
+        // The planning strategy can be chosen on the command line, e.g. -planner=dstarlite or -planner=arastar.
+        // Only a cooperative planner (the default) keeps clear of the other robots.
+        if (Application::MainApplication::isArgGiven("-planner")) {
+            planner = PathAlgorithm::CreatePlanner(Application::MainApplication::getArg("-planner").value);
+        }
     }
 
     /**
@@ -65,7 +78,7 @@ namespace Model {
             stopCommunicating();
         }
 
-        std::cout << "Remove robot\n";
+        Application::Logger::log("Remove robot");
     }
 
     /**
@@ -92,6 +105,7 @@ namespace Model {
     void Robot::setSize(const wxSize &aSize,
                         bool aNotifyObservers /*= true*/) {
         size = aSize;
+        updateCorners();
         if (aNotifyObservers == true) {
             notifyObservers();
         }
@@ -121,6 +135,7 @@ namespace Model {
     void Robot::setFront(const BoundedVector &aVector,
                          bool aNotifyObservers /*= true*/) {
         front = aVector;
+        updateCorners();
         if (aNotifyObservers == true) {
             notifyObservers();
         }
@@ -144,6 +159,13 @@ namespace Model {
         }
     }
 
+    /**
+     *
+     */
+    void Robot::setPlanner(PathAlgorithm::PlannerPtr aPlanner) {
+        planner = aPlanner;
+    }
+
     /**
      *
      */
@@ -175,6 +197,8 @@ namespace Model {
             sendStart();
         }
 
+        // A path of a previous drive does not start here
+        path.clear();
         pathPoint = 0;
         driving = true;
 
@@ -189,11 +213,16 @@ namespace Model {
      */
     void Robot::stopDriving() {
         driving = false;
+
+        if (routeRequest) {
+            routeRequest->cancel();
+            routeRequest.reset();
+        }
+        RobotWorld::getRobotWorld().release(getObjectId());
     }
 
     void Robot::recalculate(bool toStart) {
         calculateRoute(toStart);
-        pathPoint = 0;
     }
 
     /**
@@ -220,19 +249,6 @@ namespace Model {
     }
 
 
-    int Robot::minDistance() {
-        wxPoint self = position;
-
-        RobotPtr otherRobot = RobotWorld::getRobotWorld().getRobot("Bram");
-        if (!otherRobot) {
-            return std::numeric_limits<int>().max();
-        }
-
-        wxPoint other = otherRobot->position;
-
-        return std::sqrt(std::pow(other.x - self.x, 2) + std::pow(other.y - self.y, 2) * 1.0);
-    }
-
     /**
      *
      */
@@ -266,7 +282,8 @@ namespace Model {
      *
      */
     wxRegion Robot::getRegion() const {
-        wxPoint translatedPoints[] = {getFrontRight(), getFrontLeft(), getBackLeft(), getBackRight()};
+        Corners corners = getCorners();
+        wxPoint translatedPoints[] = {corners.frontRight, corners.frontLeft, corners.backLeft, corners.backRight};
         return wxRegion(4, translatedPoints); // @suppress("Avoid magic numbers")
     }
 
@@ -282,79 +299,71 @@ namespace Model {
     /**
      *
      */
-    wxPoint Robot::getFrontLeft() const {
-        // x and y are pointing to top left now
-        int x = position.x - (size.x / 2);
-        int y = position.y - (size.y / 2);
-
-        wxPoint originalFrontLeft(x, y);
-        double angle = Utils::Shape2DUtils::getAngle(front) + 0.5 * Utils::PI;
+    Utils::OrientedBox Robot::getOrientedBox() const {
+        return Utils::OrientedBox{static_cast<double>(position.x), static_cast<double>(position.y), headingCos, headingSin,
+                                  std::abs(size.x) / 2.0, std::abs(size.y) / 2.0};
+    }
 
-        wxPoint frontLeft(static_cast<int>((originalFrontLeft.x - position.x) * std::cos(angle) -
-                                           (originalFrontLeft.y - position.y) * std::sin(angle) + position.x),
-                          static_cast<int>((originalFrontLeft.y - position.y) * std::cos(angle) +
-                                           (originalFrontLeft.x - position.x) * std::sin(angle) + position.y));
+    /**
+     *
+     */
+    Robot::Corners Robot::getCorners() const {
+        return Corners{getCorner(0), getCorner(1), getCorner(2), getCorner(3)};
+    }
 
-        return frontLeft;
+    /**
+     *
+     */
+    wxPoint Robot::getFrontLeft() const {
+        return getCorner(0);
     }
 
     /**
      *
      */
     wxPoint Robot::getFrontRight() const {
-        // x and y are pointing to top left now
-        int x = position.x - (size.x / 2);
-        int y = position.y - (size.y / 2);
-
-        wxPoint originalFrontRight(x + size.x, y);
-        double angle = Utils::Shape2DUtils::getAngle(front) + 0.5 * Utils::PI;
-
-        wxPoint frontRight(static_cast<int>((originalFrontRight.x - position.x) * std::cos(angle) -
-                                            (originalFrontRight.y - position.y) * std::sin(angle) + position.x),
-                           static_cast<int>((originalFrontRight.y - position.y) * std::cos(angle) +
-                                            (originalFrontRight.x - position.x) * std::sin(angle) + position.y));
-
-        return frontRight;
+        return getCorner(1);
     }
 
     /**
      *
      */
     wxPoint Robot::getBackLeft() const {
-        // x and y are pointing to top left now
-        int x = position.x - (size.x / 2);
-        int y = position.y - (size.y / 2);
-
-        wxPoint originalBackLeft(x, y + size.y);
-
-        double angle = Utils::Shape2DUtils::getAngle(front) + 0.5 * Utils::PI;
-
-        wxPoint backLeft(static_cast<int>((originalBackLeft.x - position.x) * std::cos(angle) -
-                                          (originalBackLeft.y - position.y) * std::sin(angle) + position.x),
-                         static_cast<int>((originalBackLeft.y - position.y) * std::cos(angle) +
-                                          (originalBackLeft.x - position.x) * std::sin(angle) + position.y));
-
-        return backLeft;
+        return getCorner(2);
     }
 
     /**
      *
      */
     wxPoint Robot::getBackRight() const {
-        // x and y are pointing to top left now
-        int x = position.x - (size.x / 2);
-        int y = position.y - (size.y / 2);
-
-        wxPoint originalBackRight(x + size.x, y + size.y);
+        return getCorner(3);
+    }
 
-        double angle = Utils::Shape2DUtils::getAngle(front) + 0.5 * Utils::PI;
+    /**
+     *
+     */
+    wxPoint Robot::getCorner(std::size_t aCorner) const {
+        return wxPoint(static_cast<int>(cornerOffsets[aCorner][0] + position.x),
+                       static_cast<int>(cornerOffsets[aCorner][1] + position.y));
+    }
 
-        wxPoint backRight(static_cast<int>((originalBackRight.x - position.x) * std::cos(angle) -
-                                           (originalBackRight.y - position.y) * std::sin(angle) + position.x),
-                          static_cast<int>((originalBackRight.y - position.y) * std::cos(angle) +
-                                           (originalBackRight.x - position.x) * std::sin(angle) + position.y));
+    /**
+     *
+     */
+    void Robot::updateCorners() {
+        // The corners of the upright robot relative to its position, the top left one first
+        int left = -(size.x / 2);
+        int top = -(size.y / 2);
+        const int corners[4][2] = {{left, top}, {left + size.x, top}, {left, top + size.y}, {left + size.x, top + size.y}};
 
-        return backRight;
+        // Rotated so that size.x is the width of the front edge
+        double angle = Utils::Shape2DUtils::getAngle(front) + 0.5 * Utils::PI;
+        headingCos = std::cos(angle);
+        headingSin = std::sin(angle);
+        for (std::size_t corner = 0; corner < 4; ++corner) {
+            cornerOffsets[corner][0] = corners[corner][0] * headingCos - corners[corner][1] * headingSin;
+            cornerOffsets[corner][1] = corners[corner][1] * headingCos + corners[corner][0] * headingSin;
+        }
     }
 
     /**
@@ -435,10 +444,15 @@ namespace Model {
                     Model::RobotPtr robot = robotMessage.newRobot();
                     RobotWorld::getRobotWorld().addRobot(robot);
 
-                    robot->walls.push_back(RobotWorld::getRobotWorld().newWall(wxPoint(0, 0), wxPoint(0, 0)));
-                    robot->walls.push_back(RobotWorld::getRobotWorld().newWall(wxPoint(0, 0), wxPoint(0, 0)));
-                    robot->walls.push_back(RobotWorld::getRobotWorld().newWall(wxPoint(0, 0), wxPoint(0, 0)));
-                    robot->walls.push_back(RobotWorld::getRobotWorld().newWall(wxPoint(0, 0), wxPoint(0, 0)));
+                    // A cooperative planner avoids the reservations of the other robot, any other planner
+                    // can only avoid the other robot as walls around its current position
+                    if (planner->getReservationWindow() == 0) {
+                        robot->walls.push_back(RobotWorld::getRobotWorld().newWall(wxPoint(0, 0), wxPoint(0, 0)));
+                        robot->walls.push_back(RobotWorld::getRobotWorld().newWall(wxPoint(0, 0), wxPoint(0, 0)));
+                        robot->walls.push_back(RobotWorld::getRobotWorld().newWall(wxPoint(0, 0), wxPoint(0, 0)));
+                        robot->walls.push_back(RobotWorld::getRobotWorld().newWall(wxPoint(0, 0), wxPoint(0, 0)));
+                    }
+                    robotMessage.updateRobot(*robot);
                 }
 
                 notifyObservers();
@@ -488,21 +502,28 @@ namespace Model {
             return;
         }
 
+        Corners corners = getCorners();
+
+        // The 8 end points that move are one change of the walls
+        RobotWorld::getRobotWorld().beginWallChanges();
+
         // front
-        walls[0]->setPoint1(getFrontLeft());
-        walls[0]->setPoint2(getFrontRight());
+        walls[0]->setPoint1(corners.frontLeft);
+        walls[0]->setPoint2(corners.frontRight);
 
         // back
-        walls[1]->setPoint1(getBackLeft());
-        walls[1]->setPoint2(getBackRight());
+        walls[1]->setPoint1(corners.backLeft);
+        walls[1]->setPoint2(corners.backRight);
 
         // left
-        walls[2]->setPoint1(getFrontLeft());
-        walls[2]->setPoint2(getBackLeft());
+        walls[2]->setPoint1(corners.frontLeft);
+        walls[2]->setPoint2(corners.backLeft);
 
         // right
-        walls[3]->setPoint1(getFrontRight());
-        walls[3]->setPoint2(getBackRight());
+        walls[3]->setPoint1(corners.frontRight);
+        walls[3]->setPoint2(corners.backRight);
+
+        RobotWorld::getRobotWorld().endWallChanges();
     }
 
     /**
@@ -517,61 +538,16 @@ namespace Model {
         return os.str();
     }
 
-    void Robot::step(int msInterval) {
+    void Robot::step(int /*msInterval*/) {
         if (!driving) {
             return;
         }
 
-        int avoidModeDist = 70;
-
-        if (isBackTracking) {
-            backTrackingFor += msInterval;
-
-            if(backTrackingFor > 5000) {
-                backTrackingFor = 0;
-                avoidingForMs = 0;
-                recalculate();
-                isBackTracking = false;
-            }
-
-        } else if (inAvoidMode) {
-            avoidingForMs += msInterval;
-
-            if (minDistance() > avoidModeDist) {
-                TRACE_DEVELOP("NOT AVOIDING ANYMORE");
-                inAvoidMode = false;
-                avoidingForMs = 0;
-            }
-
-            if (!isMaster) {
-                if (avoidingForMs > 8000) {
-                    TRACE_DEVELOP("START BACKTRACKING");
-                    isBackTracking = true;
-                    avoidingForMs = 0;
-                    recalculate(true);
-                }
-
-                return;
-            }
-            else {
-                if (avoidingForMs > 100) {
-                    avoidingForMs = 0;
-                    inAvoidMode = false;
-                    recalculate();
-                }
-            }
-        } else if (!isBackTracking) {
-            if (minDistance() < avoidModeDist) {
-                inAvoidMode = true;
-
-                if (isMaster) {
-                    TRACE_DEVELOP("AVOIDING");
-                    recalculate();
-                }
-            }
-        }
-
-        if (path.size() == 0) {
+        // A cooperative path only keeps clear of the other robots within the window of the planner,
+        // so it is planned again before the window runs out
+        bool windowPassed = planner->getReservationWindow() > 0 &&
+                            RobotWorld::getRobotWorld().getStepCount() >= replanStep;
+        if ((path.size() == 0 || windowPassed) && !routeRequest) {
             recalculate();
         }
 
@@ -588,12 +564,12 @@ namespace Model {
         startPosition = position;
 
         if (position.x > 0 && position.x < 500 && position.y > 0 && position.y < 500 &&
-            pathPoint < path.size()) {
+            pathPoint + 1 < path.size()) {
             // Do the update
-            const PathAlgorithm::Vertex &vertex = path[pathPoint += static_cast<unsigned int>(speed)];
-            front = BoundedVector(vertex.asPoint(), position);
-            position.x = vertex.x;
-            position.y = vertex.y;
+            wxPoint next = advanceAlongPath(position, pathPoint, static_cast<unsigned int>(speed));
+            setFront(BoundedVector(next, position), false);
+            position.x = next.x;
+            position.y = next.y;
 
             // Stop on arrival or collision
             if (arrived(goal) || collision()) {
@@ -606,28 +582,139 @@ namespace Model {
         }
     }
 
+    /**
+     *
+     */
+    wxPoint Robot::advanceAlongPath(const wxPoint &aPosition,
+                                    unsigned int &aPathPoint,
+                                    unsigned int aNumberOfSteps) const {
+        wxPoint next = aPosition;
+        while (aNumberOfSteps > 0 && aPathPoint + 1 < path.size()) {
+            // A step is one pixel in x and/or y, so a segment takes as many steps as its Chebyshev length.
+            // A waypoint that repeats the previous one is a step of waiting.
+            const wxPoint waypoint = path[aPathPoint + 1].asPoint();
+            unsigned int segmentSteps = static_cast<unsigned int>(std::max(std::abs(waypoint.x - next.x),
+                                                                           std::abs(waypoint.y - next.y)));
+            segmentSteps = std::max(segmentSteps, 1U);
+            if (segmentSteps <= aNumberOfSteps) {
+                next = waypoint;
+                ++aPathPoint;
+                aNumberOfSteps -= segmentSteps;
+            } else {
+                double fraction = static_cast<double>(aNumberOfSteps) / segmentSteps;
+                next.x += static_cast<int>(std::lround((waypoint.x - next.x) * fraction));
+                next.y += static_cast<int>(std::lround((waypoint.y - next.y) * fraction));
+                aNumberOfSteps = 0;
+            }
+        }
+        return next;
+    }
+
+    /**
+     *
+     */
+    unsigned int Robot::getStepLength() const {
+        return std::max(static_cast<unsigned int>(speed), 1U);
+    }
+
+    /**
+     *
+     */
+    std::vector<wxPoint> Robot::getTrajectory(unsigned long aSteps) const {
+        std::vector<wxPoint> trajectory;
+        trajectory.reserve(aSteps);
+
+        wxPoint point = position;
+        unsigned int nextPathPoint = pathPoint;
+        while (trajectory.size() < aSteps) {
+            trajectory.push_back(point);
+            point = advanceAlongPath(point, nextPathPoint, getStepLength());
+        }
+        return trajectory;
+    }
+
+    /**
+     *
+     */
+    bool Robot::reserve(const std::vector<wxPoint> &aTrajectory) {
+        return RobotWorld::getRobotWorld().reserve(getObjectId(), aTrajectory, PathAlgorithm::Planner::getFreeRadius(size));
+    }
+
     /**
      *
      */
     void Robot::calculateRoute(bool toStart) {
-        path.clear();
         GoalPtr aGoal = goal;
 
         if (aGoal) {
-            // Turn off logging if not debugging AStar
-            Application::Logger::setDisable();
+            setFront(BoundedVector(aGoal->getPosition(), position), false);
 
-            front = BoundedVector(aGoal->getPosition(), position);
-            //handleNotificationsFor( astar);
+            // The route is searched on a worker thread. The robot keeps following its current path (if any)
+            // until the new one is delivered, a search that is still running for an older request is stopped.
+            if (routeRequest) {
+                routeRequest->cancel();
+            }
 
-            if (toStart) {
-                path = astar.search(position, start, size);
-            } else {
-                path = astar.search(position, aGoal->getPosition(), size);
+            routeToStart = toStart;
+            std::weak_ptr<Robot> self = toPtr<Robot>();
+            wxPoint target = toStart ? start : aGoal->getPosition();
+
+            // A cooperative planner keeps clear of the reservations of the other robots
+            PathAlgorithm::ReservationContext reservationContext;
+            if (planner->getReservationWindow() > 0) {
+                reservationContext.reservationTable = RobotWorld::getRobotWorld().getReservationSnapshot();
+                reservationContext.robot = getObjectId();
+                reservationContext.firstStep = RobotWorld::getRobotWorld().getStepCount();
+                reservationContext.stepLength = getStepLength();
             }
-            //stopHandlingNotificationsFor( astar);
+            requestStep = RobotWorld::getRobotWorld().getStepCount();
+
+            routeRequest = PathAlgorithm::PlanningService::getPlanningService().requestPath(planner, position, target, size,
+                    [self](const PathAlgorithm::Path &aPath) {
+                        RobotPtr robot = self.lock();
+                        if (robot) {
+                            robot->routeCalculated(aPath);
+                        }
+                    },
+                    reservationContext);
+        }
+    }
+
+    /**
+     *
+     */
+    void Robot::routeCalculated(const PathAlgorithm::Path &aPath) {
+        routeRequest.reset();
+
+        // An anytime planner that ran out of time before it found a path will find it on the next request,
+        // until then the robot keeps its current path
+        if (!aPath.empty() || !planner->isImprovable()) {
+            path = aPath;
+            pathPoint = 0;
+            notifyObservers();
+        }
 
-            Application::Logger::setDisable(false);
+        // A cooperative path has a vertex per pixel of time from the step of the request on, the robot joins it
+        // at the vertex of the current step so that it keeps to its reservations when the path came in late.
+        // It reserves the window of the path and plans again before half of it has passed. If another robot
+        // reserved the same place while this path was planned it is planned again right away.
+        unsigned long window = planner->getReservationWindow();
+        if (window > 0 && !path.empty()) {
+            unsigned long elapsed = (RobotWorld::getRobotWorld().getStepCount() - requestStep) * getStepLength();
+            pathPoint = static_cast<unsigned int>(std::min<unsigned long>(elapsed, path.size() - 1));
+        }
+        if (driving && window > 0) {
+            replanStep = RobotWorld::getRobotWorld().getStepCount() + std::max(window / 2, 1UL);
+            trajectoryChanged = true;
+            if (!reserve(getTrajectory(window))) {
+                calculateRoute(routeToStart);
+                return;
+            }
+        }
+
+        // An anytime planner improves the path within its time budget on every step until it is the shortest
+        if (driving && planner->isImprovable()) {
+            calculateRoute(routeToStart);
         }
     }
 
@@ -655,6 +742,13 @@ namespace Model {
 
     void Robot::sendPosition() {
         Messaging::SyncRobotMessage robotMessage(*this);
+
+        // The other side reserves the rest of the window for this robot
+        if (trajectoryChanged) {
+            robotMessage.setTrajectory(getTrajectory(planner->getReservationWindow()));
+            trajectoryChanged = false;
+        }
+
         Messaging::Message msg;
         robotMessage.fillMessage(msg);
         sendMessage(msg);
@@ -681,25 +775,36 @@ namespace Model {
      *
      */
     bool Robot::collision() {
-        wxPoint frontLeft = getFrontLeft();
-        wxPoint frontRight = getFrontRight();
-        wxPoint backLeft = getBackLeft();
-        wxPoint backRight = getBackRight();
+        Utils::Contact contact;
+        return collision(contact);
+    }
 
-        const std::vector <WallPtr> &walls = RobotWorld::getRobotWorld().getWalls();
+    /**
+     *
+     */
+    bool Robot::collision(Utils::Contact &aContact) {
+        Utils::OrientedBox box = getOrientedBox();
+
+        // Only the walls near the robot can touch it, the corners are within this radius of its position
+        int radius = static_cast<int>(std::ceil(std::hypot(size.x, size.y) / 2.0)) + 1;
+        std::vector <WallPtr> walls = RobotWorld::getRobotWorld().findWalls(position, radius);
         for (WallPtr wall: walls) {
-            if (Utils::Shape2DUtils::intersect(frontLeft, frontRight, wall->getPoint1(), wall->getPoint2()) ||
-                Utils::Shape2DUtils::intersect(frontLeft, backLeft, wall->getPoint1(), wall->getPoint2()) ||
-                Utils::Shape2DUtils::intersect(frontRight, backRight, wall->getPoint1(), wall->getPoint2())) {
+            Utils::LineSegment segment{static_cast<double>(wall->getPoint1().x), static_cast<double>(wall->getPoint1().y),
+                                       static_cast<double>(wall->getPoint2().x), static_cast<double>(wall->getPoint2().y)};
+            if (Utils::Collide(box, segment, aContact)) {
                 return true;
             }
         }
+
+        // The bounding boxes are the broad phase, only robots whose boxes overlap are tested exactly
+        Utils::BoundingBox bounds = box.getBoundingBox();
         const std::vector <RobotPtr> &robots = RobotWorld::getRobotWorld().getRobots();
         for (RobotPtr robot: robots) {
             if (getObjectId() == robot->getObjectId()) {
                 continue;
             }
-            if (intersects(robot->getRegion())) {
+            Utils::OrientedBox otherBox = robot->getOrientedBox();
+            if (bounds.overlaps(otherBox.getBoundingBox()) && Utils::Collide(box, otherBox, aContact)) {
                 return true;
             }
         }
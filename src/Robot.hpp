@@ -5,15 +5,18 @@
 
 #include "AStar.hpp"
 #include "BoundedVector.hpp"
+#include "Collision.hpp"
 #include "Message.hpp"
 #include "MessageHandler.hpp"
 #include "ModelObject.hpp"
 #include "Observer.hpp"
+#include "PlanningService.hpp"
 #include "Point.hpp"
 #include "Region.hpp"
 #include "Wall.hpp"
 #include "Size.hpp"
 
+#include <cstddef>
 #include <iostream>
 #include <memory>
 #include <mutex>
@@ -171,6 +174,24 @@ namespace Model
 			 *
 			 */
 			bool intersects( const wxRegion& aRegion) const;
+			/**
+			 * The rectangle the robot covers, as used by the collision tests
+			 */
+			Utils::OrientedBox getOrientedBox() const;
+			/**
+			 *
+			 */
+			struct Corners
+			{
+					wxPoint frontLeft;
+					wxPoint frontRight;
+					wxPoint backLeft;
+					wxPoint backRight;
+			};
+			/**
+			 * All four corners at once, the same points as getFrontLeft etc.
+			 */
+			Corners getCorners() const;
 			/**
 			 *
 			 */
@@ -203,8 +224,25 @@ namespace Model
 			 */
 			PathAlgorithm::OpenSet getOpenSet() const
 			{
-				return astar.getOpenSet();
+				// The planner belongs to a worker thread while the route is calculated, and after a cancelled
+				// request until the worker has stopped searching
+				if (PathAlgorithm::PlanningService::getPlanningService().isPlannerBusy( *planner))
+				{
+					return PathAlgorithm::OpenSet();
+				}
+				return planner->getOpenSet();
 			}
+			/**
+			 *
+			 */
+			PathAlgorithm::PlannerPtr getPlanner() const
+			{
+				return planner;
+			}
+			/**
+			 * The planner is used from the next route calculation on
+			 */
+			void setPlanner( PathAlgorithm::PlannerPtr aPlanner);
 			/**
 			 *
 			 */
@@ -264,18 +302,45 @@ namespace Model
 
             void step(int msInterval);
 
-            int minDistance();
-
             void updateWalls();
+			/**
+			 * @return the positions of the robot on its current path for the coming aSteps steps, the first one is the current position
+			 */
+			std::vector<wxPoint> getTrajectory(unsigned long aSteps) const;
+			/**
+			 * Reserves aTrajectory for this robot in the RobotWorld, the first point for the current step
+			 *
+			 * @return false if the trajectory runs into a reservation of another robot
+			 */
+			bool reserve(const std::vector<wxPoint>& aTrajectory);
     protected:
 			/**
 			 *
 			 */
 			void drive();
 			/**
+			 * Moves from aPosition aNumberOfSteps pixel steps further along the path, the path may be
+			 * sparse (waypoints only) in which case the position is interpolated between the waypoints.
+			 * aPathPoint is the waypoint that was passed last, it is updated.
 			 *
+			 * @return the new position
+			 */
+			wxPoint advanceAlongPath(const wxPoint& aPosition,
+									 unsigned int& aPathPoint,
+									 unsigned int aNumberOfSteps) const;
+			/**
+			 * @return the number of pixel steps the robot moves per step of the RobotWorld
+			 */
+			unsigned int getStepLength() const;
+			/**
+			 * Requests the route to the goal (or back to the start) from the PlanningService and cancels the
+			 * previous request if it has not been delivered yet
 			 */
 			void calculateRoute(bool toStart);
+			/**
+			 * Called on the GUI thread when the route of the latest request is delivered
+			 */
+			void routeCalculated(const PathAlgorithm::Path& aPath);
 			/**
 			 *
 			 */
@@ -284,7 +349,19 @@ namespace Model
 			 *
 			 */
 			bool collision();
+			/**
+			 * Like collision, aContact tells how deep the robot is in the wall or the other robot it hit first
+			 */
+			bool collision( Utils::Contact& aContact);
 		private:
+			/**
+			 * Corner 0 is the front left one, then front right, back left and back right
+			 */
+			wxPoint getCorner( std::size_t aCorner) const;
+			/**
+			 * Rotates the corners again, called if the front or the size changes. A move only shifts the corners.
+			 */
+			void updateCorners();
 			/**
 			 *
 			 */
@@ -301,6 +378,15 @@ namespace Model
 			 *
 			 */
 			BoundedVector front;
+			/**
+			 * The cosine and sine of the angle the robot is rotated by (see updateCorners)
+			 */
+			double headingCos;
+			double headingSin;
+			/**
+			 * The corners relative to the position (see getCorner)
+			 */
+			double cornerOffsets[4][2];
 			/**
 			 *
 			 */
@@ -312,7 +398,7 @@ namespace Model
 			/**
 			 *
 			 */
-			PathAlgorithm::AStar astar;
+			PathAlgorithm::PlannerPtr planner;
 			/**
 			 *
 			 */
@@ -338,16 +424,19 @@ namespace Model
 
             unsigned int pathPoint = 0;
 
-            std::vector<Model::WallPtr> walls;
+            PathAlgorithm::PathRequestPtr routeRequest;
 
-            bool inAvoidMode = false;
+            bool routeToStart = false;
 
-            int avoidingForMs = 0;
+            std::vector<Model::WallPtr> walls;
 
             wxPoint start;
 
-            bool isBackTracking = false;
-            int backTrackingFor = 0;
+            unsigned long requestStep = 0;
+
+            unsigned long replanStep = 0;
+
+            bool trajectoryChanged = false;
 	};
 } // namespace Model
 #endif // ROBOT_HPP_
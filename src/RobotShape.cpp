@@ -95,7 +95,8 @@ namespace View
 	 */
 	bool RobotShape::occupies( const wxPoint& aPoint) const
 	{
-		wxPoint cornerPoints[] = { getRobot()->getFrontRight(), getRobot()->getFrontLeft(), getRobot()->getBackLeft(), getRobot()->getBackRight() };
+		Model::Robot::Corners corners = getRobot()->getCorners();
+		wxPoint cornerPoints[] = { corners.frontRight, corners.frontLeft, corners.backLeft, corners.backRight };
 		return Utils::Shape2DUtils::isInsidePolygon( cornerPoints, 4, aPoint);
 	}
 	/**
@@ -193,9 +194,10 @@ namespace View
 		if (path.size() != 0)
 		{
 			dc.SetPen( wxPen(  "BLACK", borderWidth, wxPENSTYLE_SOLID));
-			for (const PathAlgorithm::Vertex &vertex : path)
+			// A smoothed path only holds the corners, the robot drives straight from one to the next
+			for (std::size_t i = 1; i < path.size(); ++i)
 			{
-				dc.DrawPoint( vertex.asPoint());
+				dc.DrawLine( path[i - 1].asPoint(), path[i].asPoint());
 			}
 		}
 	}
@@ -213,7 +215,8 @@ namespace View
 		{
 			dc.SetPen( wxPen( getNormalColour(), borderWidth, wxPENSTYLE_SOLID));
 		}
-		wxPoint cornerPoints[] = { getRobot()->getFrontRight(), getRobot()->getFrontLeft(), getRobot()->getBackLeft(), getRobot()->getBackRight() };
+		Model::Robot::Corners corners = getRobot()->getCorners();
+		wxPoint cornerPoints[] = { corners.frontRight, corners.frontLeft, corners.backLeft, corners.backRight };
 		dc.DrawPolygon( 4, cornerPoints);
 
 		dc.SetPen( wxPen(  "RED", borderWidth + 2, wxPENSTYLE_SOLID));
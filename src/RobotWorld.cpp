@@ -2,6 +2,7 @@
 
 #include "Goal.hpp"
 #include "Logger.hpp"
+#include "PlanningService.hpp"
 #include "Robot.hpp"
 #include "Wall.hpp"
 #include "WayPoint.hpp"
@@ -80,6 +81,11 @@ namespace Model {
     void RobotWorld::addWall(WallPtr wall, bool aNotifyObservers) {
         std::lock_guard <std::mutex> guard(worldMutex);
         walls.push_back(wall);
+        {
+            std::lock_guard <std::mutex> indexGuard(wallIndexMutex);
+            wallIndex.insert(wall.get(), wall->getPoint1(), wall->getPoint2());
+        }
+        wallsChanged();
         if (aNotifyObservers)
         {
             notifyObservers();
@@ -109,6 +115,7 @@ namespace Model {
 		if (i != robots.end())
 		{
 			robots.erase( i);
+			release( aRobot->getObjectId());
 			if (aNotifyObservers)
 			{
 				notifyObservers();
@@ -168,7 +175,12 @@ namespace Model {
                     aWall->getPoint2() == w->getPoint2();
         });
         if (i != walls.end()) {
+            {
+                std::lock_guard <std::mutex> indexGuard(wallIndexMutex);
+                wallIndex.erase(i->get());
+            }
             walls.erase(i);
+            wallsChanged();
 
             if (aNotifyObservers == true) {
                 notifyObservers();
@@ -179,6 +191,8 @@ namespace Model {
         std::lock_guard <std::mutex> guard(worldMutex);
 
         walls.clear();
+        rebuildWallIndex();
+        wallsChanged();
 
         if (aNotifyObservers)
         {
@@ -313,6 +327,149 @@ namespace Model {
         return walls;
     }
 
+    /**
+     *
+     */
+    unsigned long RobotWorld::getWallsVersion() const {
+        return wallsVersion.load();
+    }
+
+    /**
+     *
+     */
+    void RobotWorld::wallsChanged() {
+        if (wallChangesDeferred > 0) {
+            wallsChangedDeferred = true;
+            return;
+        }
+        ++wallsVersion;
+    }
+
+    /**
+     *
+     */
+    void RobotWorld::beginWallChanges() {
+        ++wallChangesDeferred;
+    }
+
+    /**
+     *
+     */
+    void RobotWorld::endWallChanges() {
+        if (--wallChangesDeferred == 0 && wallsChangedDeferred.exchange(false)) {
+            ++wallsVersion;
+        }
+    }
+
+    /**
+     *
+     */
+    void RobotWorld::wallMoved(const Wall &aWall) {
+        {
+            // A wall that is not in the world yet is not in the index either, it is indexed when it is added and
+            // nothing that is derived from the walls depends on it until then
+            std::lock_guard <std::mutex> guard(wallIndexMutex);
+            if (!wallIndex.update(&aWall, aWall.getPoint1(), aWall.getPoint2())) {
+                return;
+            }
+        }
+        wallsChanged();
+    }
+
+    /**
+     *
+     */
+    std::vector <WallPtr> RobotWorld::findWalls(const wxPoint &aPoint,
+                                                int aRadius) const {
+        return findWalls(aPoint, aPoint, aRadius);
+    }
+
+    /**
+     *
+     */
+    std::vector <WallPtr> RobotWorld::findWalls(const wxPoint &aPoint1,
+                                                const wxPoint &aPoint2,
+                                                int aRadius) const {
+        std::vector<const Wall *> found;
+        std::vector <WallPtr> result;
+        std::lock_guard <std::mutex> guard(wallIndexMutex);
+        wallIndex.find(aPoint1, aPoint2, aRadius, found);
+        // Every wall in the index is owned by the walls of the world
+        result.reserve(found.size());
+        for (const Wall *wall: found) {
+            result.push_back(std::const_pointer_cast<Wall>(std::static_pointer_cast<const Wall>(wall->shared_from_this())));
+        }
+        return result;
+    }
+
+    /**
+     *
+     */
+    void RobotWorld::rebuildWallIndex() {
+        std::lock_guard <std::mutex> guard(wallIndexMutex);
+        wallIndex.clear();
+        for (WallPtr wall: walls) {
+            wallIndex.insert(wall.get(), wall->getPoint1(), wall->getPoint2());
+        }
+    }
+
+    /**
+     *
+     */
+    PathAlgorithm::WallSnapshotPtr RobotWorld::getWallSnapshot() {
+        std::lock_guard <std::mutex> guard(wallSnapshotMutex);
+
+        unsigned long version = wallsVersion.load();
+        if (!wallSnapshot || wallSnapshot->getWallsVersion() != version) {
+            wallSnapshot = std::make_shared<const PathAlgorithm::WallSnapshot>(walls, version);
+        }
+        return wallSnapshot;
+    }
+
+    /**
+     *
+     */
+    PathAlgorithm::ClearanceMapPtr RobotWorld::getClearanceMap(int aMinimumMargin /*= 64*/) {
+        return getWallSnapshot()->getClearanceMap(aMinimumMargin);
+    }
+
+    /**
+     *
+     */
+    unsigned long RobotWorld::getStepCount() const {
+        return stepCount.load();
+    }
+
+    /**
+     *
+     */
+    bool RobotWorld::reserve(const Base::ObjectId &aRobot,
+                             const std::vector<wxPoint> &aTrajectory,
+                             int aRadius) {
+        std::lock_guard<std::mutex> guard(reservationMutex);
+        return reservationTable.reserve(aRobot, stepCount.load(), aTrajectory, aRadius);
+    }
+
+    /**
+     *
+     */
+    void RobotWorld::release(const Base::ObjectId &aRobot) {
+        std::lock_guard<std::mutex> guard(reservationMutex);
+        reservationTable.release(aRobot);
+    }
+
+    /**
+     *
+     */
+    PathAlgorithm::ReservationTablePtr RobotWorld::getReservationSnapshot() {
+        std::lock_guard<std::mutex> guard(reservationMutex);
+
+        if (!reservationSnapshot || reservationSnapshot->getVersion() != reservationTable.getVersion()) {
+            reservationSnapshot = std::make_shared<const PathAlgorithm::ReservationTable>(reservationTable);
+        }
+        return reservationSnapshot;
+    }
+
     /**
      *
      */
@@ -425,9 +582,17 @@ namespace Model {
 
     void RobotWorld::step(int msInterval)
     {
-        RobotPtr  robot = getRobot("Robot");
-        if (robot)
+        // The routes that were calculated since the previous step
+        PathAlgorithm::PlanningService::getPlanningService().deliverPaths();
+
+        // A robot may add or remove walls or robots while it steps
+        std::vector<RobotPtr> steppedRobots = robots;
+        for (RobotPtr robot : steppedRobots) {
             robot->step(msInterval);
+        }
+
+        std::lock_guard<std::mutex> guard(reservationMutex);
+        reservationTable.releaseBefore(++stepCount);
     }
 
 
@@ -439,6 +604,14 @@ namespace Model {
         wayPoints.clear();
         goals.clear();
         walls.clear();
+        rebuildWallIndex();
+        wallsChanged();
+
+        {
+            std::lock_guard<std::mutex> guard(reservationMutex);
+            reservationTable = PathAlgorithm::ReservationTable();
+            reservationSnapshot.reset();
+        }
 
         if (aNotifyObservers) {
             notifyObservers();
@@ -489,6 +662,8 @@ namespace Model {
                                                             aWall->getObjectId()) == aKeepObjects.end();
                                        }),
                         walls.end());
+            rebuildWallIndex();
+            wallsChanged();
         }
 
         if (aNotifyObservers) {
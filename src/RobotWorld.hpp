@@ -4,8 +4,12 @@
 #include "Config.hpp"
 
 #include "ModelObject.hpp"
+#include "ReservationTable.hpp"
+#include "SegmentGrid.hpp"
+#include "WallSnapshot.hpp"
 #include "Widgets.hpp"
 
+#include <atomic>
 #include <vector>
 #include <mutex>
 
@@ -130,6 +134,72 @@ namespace Model
 			 *
 			 */
 			const std::vector< WallPtr >& getWalls() const;
+			/**
+			 * @return a number that changes every time a wall is added, deleted or moved
+			 */
+			unsigned long getWallsVersion() const;
+			/**
+			 * Called by Wall if its geometry changes, invalidates anything that is derived from the walls
+			 */
+			void wallsChanged();
+			/**
+			 * The walls that change until the matching endWallChanges count as one change of the walls, e.g. all
+			 * walls around a robot that moves.
+			 */
+			void beginWallChanges();
+			/**
+			 *
+			 */
+			void endWallChanges();
+			/**
+			 * Called by Wall if one of its end points moved, moves it in the wall index as well
+			 */
+			void wallMoved( const Wall& aWall);
+			/**
+			 * The walls that may come within aRadius of aPoint. Only the walls near aPoint are looked at (see
+			 * Utils::SegmentGrid), a wall that is a bit further away may be returned as well.
+			 */
+			std::vector< WallPtr > findWalls(	const wxPoint& aPoint,
+												int aRadius) const;
+			/**
+			 * The walls that may come within aRadius of the line from aPoint1 to aPoint2, like findWalls for a point
+			 */
+			std::vector< WallPtr > findWalls(	const wxPoint& aPoint1,
+												const wxPoint& aPoint2,
+												int aRadius) const;
+			/**
+			 * The snapshot is shared by all robots and is only taken again if the walls have changed. It reads the walls,
+			 * so it must be called on the thread that changes them. Planners on other threads get a snapshot handed to them.
+			 */
+			PathAlgorithm::WallSnapshotPtr getWallSnapshot();
+			/**
+			 * The clearance map of the current wall snapshot, it is only computed again if the walls have changed or
+			 * if its margin is less than aMinimumMargin.
+			 *
+			 * @param aMinimumMargin the largest robot radius the map must answer for
+			 */
+			PathAlgorithm::ClearanceMapPtr getClearanceMap( int aMinimumMargin = 64);
+			/**
+			 * @return the number of steps the world has made, the current positions of the robots are those of this step
+			 */
+			unsigned long getStepCount() const;
+			/**
+			 * Reserves the circle with aRadius around the points of aTrajectory for aRobot, the first point for the current
+			 * step and every following point for the step after it. The earlier reservations of aRobot are replaced.
+			 *
+			 * @return false if the trajectory runs into a reservation of another robot
+			 */
+			bool reserve(	const Base::ObjectId& aRobot,
+							const std::vector< wxPoint >& aTrajectory,
+							int aRadius);
+			/**
+			 * Removes all reservations of aRobot
+			 */
+			void release( const Base::ObjectId& aRobot);
+			/**
+			 * The snapshot is shared by all robots and is only taken again if the reservations have changed
+			 */
+			PathAlgorithm::ReservationTablePtr getReservationSnapshot();
 			/**
 			 *
 			 */
@@ -163,6 +233,10 @@ namespace Model
 			virtual std::string asDebugString() const override;
 			//@}
 
+			/**
+			 * Hands the routes that the PlanningService calculated to their robots, steps every robot and drops
+			 * the reservations of the step that has passed
+			 */
             void step(int msInterval);
 		protected:
 			/**
@@ -184,6 +258,55 @@ namespace Model
 			mutable std::vector< WallPtr > walls;
 
             std::mutex worldMutex;
+			/**
+			 *
+			 */
+			std::atomic< unsigned long > wallsVersion = 0;
+			/**
+			 * The number of beginWallChanges without their endWallChanges
+			 */
+			std::atomic< unsigned int > wallChangesDeferred = 0;
+			/**
+			 * True if the walls changed since the first of those beginWallChanges
+			 */
+			std::atomic< bool > wallsChangedDeferred = false;
+			/**
+			 *
+			 */
+			PathAlgorithm::WallSnapshotPtr wallSnapshot;
+			/**
+			 * Replaces the contents of the wall index with the walls
+			 */
+			void rebuildWallIndex();
+			/**
+			 * The walls by the cells they pass through, kept current by every change of the walls. A wall is indexed by
+			 * its address, so that a wall that moves finds itself in the index without looking through the walls.
+			 */
+			Utils::SegmentGrid< const Wall* > wallIndex;
+			/**
+			 * Guards wallIndex only, the robots look for walls on their own threads
+			 */
+			mutable std::mutex wallIndexMutex;
+			/**
+			 * Guards wallSnapshot only
+			 */
+			std::mutex wallSnapshotMutex;
+			/**
+			 *
+			 */
+			std::atomic< unsigned long > stepCount = 0;
+			/**
+			 *
+			 */
+			PathAlgorithm::ReservationTable reservationTable;
+			/**
+			 *
+			 */
+			PathAlgorithm::ReservationTablePtr reservationSnapshot;
+			/**
+			 * Guards reservationTable and reservationSnapshot, a remote robot reserves on the thread of the CommunicationService
+			 */
+			std::mutex reservationMutex;
 	};
 } // namespace Model
 #endif // ROBOTWORLD_HPP_
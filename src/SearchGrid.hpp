@@ -0,0 +1,136 @@
+#ifndef SEARCHGRID_HPP_
+#define SEARCHGRID_HPP_
+
+#include "Config.hpp"
+
+#include "GridExtent.hpp"
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace PathAlgorithm
+{
+	/**
+	 * Flat per-cell search state for a bounded world: the state of the cell (unvisited, open or closed),
+	 * the actual cost from the start and the cell index of the predecessor. Every access is a plain
+	 * array access and resetting the grid for the next search does not allocate unless the extent grows.
+	 *
+	 * The three are kept in separate arrays (structure of arrays), so a search that only checks the states of
+	 * the neighbours does not pull their costs and parents into the cache. CostType is the type of the actual cost,
+	 * SearchGrid has double costs and CompactSearchGrid float costs: 9 bytes per cell instead of 13.
+	 */
+	template< typename CostType >
+	class BasicSearchGrid
+	{
+		public:
+			/**
+			 *
+			 */
+			enum CellState : std::uint8_t
+			{
+				Unvisited,
+				Open,
+				Closed
+			};
+			/**
+			 *
+			 */
+			static constexpr std::uint32_t noParent = std::numeric_limits< std::uint32_t >::max();
+			/**
+			 * Makes every cell in anExtent unvisited. The cost and parent of an unvisited cell are undefined.
+			 */
+			void reset( const GridExtent& anExtent)
+			{
+				extent = anExtent;
+				std::size_t size = extent.size();
+				state.assign( size, Unvisited);
+				if (actualCost.size() < size)
+				{
+					actualCost.resize( size);
+					parent.resize( size);
+				}
+			}
+			/**
+			 *
+			 */
+			const GridExtent& getExtent() const
+			{
+				return extent;
+			}
+			/**
+			 *
+			 */
+			CellState getState( std::uint32_t anIndex) const
+			{
+				return static_cast< CellState >( state[anIndex]);
+			}
+			/**
+			 *
+			 */
+			void setState(	std::uint32_t anIndex,
+							CellState aState)
+			{
+				state[anIndex] = aState;
+			}
+			/**
+			 *
+			 */
+			bool isClosed( std::uint32_t anIndex) const
+			{
+				return state[anIndex] == Closed;
+			}
+			/**
+			 *
+			 */
+			CostType getActualCost( std::uint32_t anIndex) const
+			{
+				return actualCost[anIndex];
+			}
+			/**
+			 *
+			 */
+			void setActualCost(	std::uint32_t anIndex,
+								CostType aCost)
+			{
+				actualCost[anIndex] = aCost;
+			}
+			/**
+			 *
+			 */
+			std::uint32_t getParent( std::uint32_t anIndex) const
+			{
+				return parent[anIndex];
+			}
+			/**
+			 *
+			 */
+			void setParent(	std::uint32_t anIndex,
+							std::uint32_t aParent)
+			{
+				parent[anIndex] = aParent;
+			}
+
+		private:
+			/**
+			 *
+			 */
+			GridExtent extent;
+			/**
+			 * One CellState per cell
+			 */
+			std::vector< std::uint8_t > state;
+			/**
+			 *
+			 */
+			std::vector< CostType > actualCost;
+			/**
+			 *
+			 */
+			std::vector< std::uint32_t > parent;
+	};
+	// class BasicSearchGrid
+	typedef BasicSearchGrid< double > SearchGrid;
+	typedef BasicSearchGrid< float > CompactSearchGrid;
+} // namespace PathAlgorithm
+#endif // SEARCHGRID_HPP_
@@ -0,0 +1,238 @@
+#ifndef SEGMENTGRID_HPP_
+#define SEGMENTGRID_HPP_
+
+#include "Config.hpp"
+
+#include "Point.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Utils
+{
+	/**
+	 * A uniform grid over line segments, each segment is listed in every square cell it passes through. A query
+	 * only looks at the cells around the query, which makes its cost depend on the number of segments nearby
+	 * instead of the number of segments in the grid.
+	 *
+	 * The queries return candidates: every segment that comes within the distance of the query is returned, a
+	 * segment that is a bit further away may be returned as well. The caller does the exact test.
+	 *
+	 * Key identifies a segment, it must be hashable and less than comparable (e.g. a pointer or an index).
+	 */
+	template< typename Key >
+	class SegmentGrid
+	{
+		public:
+			/**
+			 *
+			 */
+			explicit SegmentGrid( int aCellSize = 64) :
+							cellSize( std::max( aCellSize, 1))
+			{
+			}
+			/**
+			 * Adds the segment from aPoint1 to aPoint2, a segment with the same key is moved there
+			 */
+			void insert(	const Key& aKey,
+							const wxPoint& aPoint1,
+							const wxPoint& aPoint2)
+			{
+				erase( aKey);
+				segments.emplace( aKey, std::make_pair( aPoint1, aPoint2));
+				forEachCell( aPoint1, aPoint2, 0, [this, &aKey]( std::uint64_t aCell)
+				{
+					cells[aCell].push_back( aKey);
+				});
+			}
+			/**
+			 * @return false if there is no segment with aKey
+			 */
+			bool erase( const Key& aKey)
+			{
+				auto i = segments.find( aKey);
+				if (i == segments.end())
+				{
+					return false;
+				}
+				forEachCell( i->second.first, i->second.second, 0, [this, &aKey]( std::uint64_t aCell)
+				{
+					auto cell = cells.find( aCell);
+					cell->second.erase( std::find( cell->second.begin(), cell->second.end(), aKey));
+					if (cell->second.empty())
+					{
+						cells.erase( cell);
+					}
+				});
+				segments.erase( i);
+				return true;
+			}
+			/**
+			 * Moves the segment with aKey to aPoint1 and aPoint2 if it is in the grid
+			 *
+			 * @return false if there is no segment with aKey
+			 */
+			bool update(	const Key& aKey,
+							const wxPoint& aPoint1,
+							const wxPoint& aPoint2)
+			{
+				if (segments.find( aKey) == segments.end())
+				{
+					return false;
+				}
+				insert( aKey, aPoint1, aPoint2);
+				return true;
+			}
+			/**
+			 *
+			 */
+			void clear()
+			{
+				cells.clear();
+				segments.clear();
+			}
+			/**
+			 *
+			 */
+			std::size_t size() const
+			{
+				return segments.size();
+			}
+			/**
+			 * Replaces the contents of aKeys with the segments that may come within aRadius of aPoint
+			 */
+			void find(	const wxPoint& aPoint,
+						int aRadius,
+						std::vector< Key >& aKeys) const
+			{
+				find( aPoint, aPoint, aRadius, aKeys);
+			}
+			/**
+			 * Replaces the contents of aKeys with the segments that may come within aRadius of the segment
+			 * from aPoint1 to aPoint2, with a radius of 0 the segments that may intersect it
+			 */
+			void find(	const wxPoint& aPoint1,
+						const wxPoint& aPoint2,
+						int aRadius,
+						std::vector< Key >& aKeys) const
+			{
+				aKeys.clear();
+				forEachCell( aPoint1, aPoint2, std::max( aRadius, 0), [this, &aKeys]( std::uint64_t aCell)
+				{
+					auto cell = cells.find( aCell);
+					if (cell != cells.end())
+					{
+						aKeys.insert( aKeys.end(), cell->second.begin(), cell->second.end());
+					}
+				});
+				// A segment is listed in every cell it passes through
+				std::sort( aKeys.begin(), aKeys.end());
+				aKeys.erase( std::unique( aKeys.begin(), aKeys.end()), aKeys.end());
+			}
+
+		private:
+			/**
+			 * The cell that contains aCoordinate, rounded towards minus infinity
+			 */
+			int cellOf( int aCoordinate) const
+			{
+				return aCoordinate >= 0 ? aCoordinate / cellSize : -((-aCoordinate - 1) / cellSize) - 1;
+			}
+			/**
+			 *
+			 */
+			static std::uint64_t cellKey(	int aColumn,
+											int aRow)
+			{
+				return (static_cast< std::uint64_t >( static_cast< std::uint32_t >( aColumn)) << 32) | static_cast< std::uint32_t >( aRow);
+			}
+			/**
+			 * Calls aFunction with the key of every cell that the segment from aPoint1 to aPoint2 passes through if
+			 * the cell is grown by aMargin on every side. The cells in the bounding box of the segment are clipped
+			 * against the line (Liang-Barsky), so a long diagonal segment is not listed in the whole box.
+			 */
+			template< typename Function >
+			void forEachCell(	const wxPoint& aPoint1,
+								const wxPoint& aPoint2,
+								int aMargin,
+								Function aFunction) const
+			{
+				int firstColumn = cellOf( std::min( aPoint1.x, aPoint2.x) - aMargin);
+				int lastColumn = cellOf( std::max( aPoint1.x, aPoint2.x) + aMargin);
+				int firstRow = cellOf( std::min( aPoint1.y, aPoint2.y) - aMargin);
+				int lastRow = cellOf( std::max( aPoint1.y, aPoint2.y) + aMargin);
+
+				double dx = aPoint2.x - aPoint1.x;
+				double dy = aPoint2.y - aPoint1.y;
+				for (int column = firstColumn; column <= lastColumn; ++column)
+				{
+					for (int row = firstRow; row <= lastRow; ++row)
+					{
+						if (firstColumn == lastColumn || firstRow == lastRow ||
+							isLineInBox(	aPoint1, dx, dy,
+											static_cast< double >( column) * cellSize - aMargin,
+											static_cast< double >( column + 1) * cellSize + aMargin,
+											static_cast< double >( row) * cellSize - aMargin,
+											static_cast< double >( row + 1) * cellSize + aMargin))
+						{
+							aFunction( cellKey( column, row));
+						}
+					}
+				}
+			}
+			/**
+			 * @return true if the segment from aPoint to aPoint + (dx, dy) enters the box, the box includes its border
+			 */
+			static bool isLineInBox(	const wxPoint& aPoint,
+										double dx,
+										double dy,
+										double aLeft,
+										double aRight,
+										double aTop,
+										double aBottom)
+			{
+				double enter = 0.0;
+				double leave = 1.0;
+				const double p[] = { -dx, dx, -dy, dy };
+				const double q[] = { aPoint.x - aLeft, aRight - aPoint.x, aPoint.y - aTop, aBottom - aPoint.y };
+				for (int i = 0; i < 4; ++i)
+				{
+					if (p[i] == 0.0)
+					{
+						if (q[i] < 0.0)
+						{
+							return false;
+						}
+					} else
+					{
+						double t = q[i] / p[i];
+						if (p[i] < 0.0)
+						{
+							enter = std::max( enter, t);
+						} else
+						{
+							leave = std::min( leave, t);
+						}
+					}
+				}
+				return enter <= leave;
+			}
+			/**
+			 *
+			 */
+			int cellSize;
+			/**
+			 * The keys of the segments that pass through a cell, only cells with segments are kept
+			 */
+			std::unordered_map< std::uint64_t, std::vector< Key > > cells;
+			/**
+			 * The end points of every segment
+			 */
+			std::unordered_map< Key, std::pair< wxPoint, wxPoint > > segments;
+	};
+	// class SegmentGrid
+} // namespace Utils
+#endif // SEGMENTGRID_HPP_
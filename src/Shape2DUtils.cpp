@@ -2,11 +2,122 @@
 
 #include "Logger.hpp"
 
+#include <boost/multiprecision/cpp_int.hpp>
+
 #include <algorithm>
+#include <cmath>
 #include <sstream>
 
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 namespace Utils
 {
+#if defined(__AVX__)
+	/**
+	 * The vector operations of the batch functions on four doubles
+	 */
+	struct Lanes
+	{
+			typedef __m256d Vector;
+			static const std::size_t count = 4;
+
+			static Vector load( const int* someValues) { return _mm256_cvtepi32_pd( _mm_loadu_si128( reinterpret_cast< const __m128i* >( someValues))); }
+			static Vector set( double aValue) { return _mm256_set1_pd( aValue); }
+			static Vector sub( Vector lhs, Vector rhs) { return _mm256_sub_pd( lhs, rhs); }
+			static Vector mul( Vector lhs, Vector rhs) { return _mm256_mul_pd( lhs, rhs); }
+			static Vector min( Vector lhs, Vector rhs) { return _mm256_min_pd( lhs, rhs); }
+			static Vector max( Vector lhs, Vector rhs) { return _mm256_max_pd( lhs, rhs); }
+			static Vector lessEqual( Vector lhs, Vector rhs) { return _mm256_cmp_pd( lhs, rhs, _CMP_LE_OQ); }
+			static Vector both( Vector lhs, Vector rhs) { return _mm256_and_pd( lhs, rhs); }
+			static int mask( Vector aValue) { return _mm256_movemask_pd( aValue); }
+	};
+	// struct Lanes
+#elif defined(__SSE2__)
+	/**
+	 * The vector operations of the batch functions on two doubles
+	 */
+	struct Lanes
+	{
+			typedef __m128d Vector;
+			static const std::size_t count = 2;
+
+			static Vector load( const int* someValues) { return _mm_cvtepi32_pd( _mm_loadl_epi64( reinterpret_cast< const __m128i* >( someValues))); }
+			static Vector set( double aValue) { return _mm_set1_pd( aValue); }
+			static Vector sub( Vector lhs, Vector rhs) { return _mm_sub_pd( lhs, rhs); }
+			static Vector mul( Vector lhs, Vector rhs) { return _mm_mul_pd( lhs, rhs); }
+			static Vector min( Vector lhs, Vector rhs) { return _mm_min_pd( lhs, rhs); }
+			static Vector max( Vector lhs, Vector rhs) { return _mm_max_pd( lhs, rhs); }
+			static Vector lessEqual( Vector lhs, Vector rhs) { return _mm_cmple_pd( lhs, rhs); }
+			static Vector both( Vector lhs, Vector rhs) { return _mm_and_pd( lhs, rhs); }
+			static int mask( Vector aValue) { return _mm_movemask_pd( aValue); }
+	};
+	// struct Lanes
+#endif
+#if defined(__AVX__) || defined(__SSE2__)
+	/**
+	 * The largest absolute value of a coordinate for which IntersectionMask is exact: the differences of the
+	 * coordinates are less than 2^26, their products less than 2^52 and the orientations less than 2^53
+	 */
+	static const std::int64_t exactLanesCoordinate = std::int64_t( 1) << 25;
+	/**
+	 * intersect for the lines aFirstLine up to aFirstLine + Lanes::count of someLines: bit i of the result
+	 * is set if line aFirstLine + i intersects
+	 */
+	static int IntersectionMask(	const wxPoint& aStartLine,
+									const wxPoint& anEndLine,
+									const LineBlock& someLines,
+									std::size_t aFirstLine)
+	{
+		Lanes::Vector x1 = Lanes::set( aStartLine.x);
+		Lanes::Vector y1 = Lanes::set( aStartLine.y);
+		Lanes::Vector x2 = Lanes::set( anEndLine.x);
+		Lanes::Vector y2 = Lanes::set( anEndLine.y);
+		Lanes::Vector x3 = Lanes::load( &someLines.startX[aFirstLine]);
+		Lanes::Vector y3 = Lanes::load( &someLines.startY[aFirstLine]);
+		Lanes::Vector x4 = Lanes::load( &someLines.endX[aFirstLine]);
+		Lanes::Vector y4 = Lanes::load( &someLines.endY[aFirstLine]);
+		Lanes::Vector zero = Lanes::set( 0.0);
+
+		// The orientations of the end points of each line with respect to the other line, only their signs matter
+		Lanes::Vector dx1 = Lanes::sub( x2, x1);
+		Lanes::Vector dy1 = Lanes::sub( y2, y1);
+		Lanes::Vector dx2 = Lanes::sub( x4, x3);
+		Lanes::Vector dy2 = Lanes::sub( y4, y3);
+		Lanes::Vector orientation1 = Lanes::sub( Lanes::mul( dx1, Lanes::sub( y3, y1)), Lanes::mul( dy1, Lanes::sub( x3, x1)));
+		Lanes::Vector orientation2 = Lanes::sub( Lanes::mul( dx1, Lanes::sub( y4, y1)), Lanes::mul( dy1, Lanes::sub( x4, x1)));
+		Lanes::Vector orientation3 = Lanes::sub( Lanes::mul( dx2, Lanes::sub( y1, y3)), Lanes::mul( dy2, Lanes::sub( x1, x3)));
+		Lanes::Vector orientation4 = Lanes::sub( Lanes::mul( dx2, Lanes::sub( y2, y3)), Lanes::mul( dy2, Lanes::sub( x2, x3)));
+
+		Lanes::Vector result = Lanes::both( Lanes::lessEqual( Lanes::mul( orientation1, orientation2), zero), Lanes::lessEqual( Lanes::mul( orientation3, orientation4), zero));
+		result = Lanes::both( result, Lanes::both( Lanes::lessEqual( Lanes::min( x3, x4), Lanes::max( x1, x2)), Lanes::lessEqual( Lanes::min( x1, x2), Lanes::max( x3, x4))));
+		result = Lanes::both( result, Lanes::both( Lanes::lessEqual( Lanes::min( y3, y4), Lanes::max( y1, y2)), Lanes::lessEqual( Lanes::min( y1, y2), Lanes::max( y3, y4))));
+		return Lanes::mask( result);
+	}
+#endif
+	/**
+	 * The cross product of aPoint2 - aPoint1 and aPoint3 - aPoint1
+	 */
+	static std::int64_t CrossProduct(	const wxPoint& aPoint1,
+										const wxPoint& aPoint2,
+										const wxPoint& aPoint3)
+	{
+		return (static_cast< std::int64_t >( aPoint2.x) - aPoint1.x) * (static_cast< std::int64_t >( aPoint3.y) - aPoint1.y) -
+				(static_cast< std::int64_t >( aPoint2.y) - aPoint1.y) * (static_cast< std::int64_t >( aPoint3.x) - aPoint1.x);
+	}
+	/**
+	 * @return true if aPoint is in the axis aligned box with the corners aCorner1 and aCorner2, the border included
+	 */
+	static bool IsInBox(	const wxPoint& aPoint,
+							const wxPoint& aCorner1,
+							const wxPoint& aCorner2)
+	{
+		return std::min( aCorner1.x, aCorner2.x) <= aPoint.x && aPoint.x <= std::max( aCorner1.x, aCorner2.x) &&
+				std::min( aCorner1.y, aCorner2.y) <= aPoint.y && aPoint.y <= std::max( aCorner1.y, aCorner2.y);
+	}
 	/**
 	 *
 	 * @param aStartpoint
@@ -52,7 +163,20 @@ namespace Utils
 												const wxPoint& aStartLine2,
 												const wxPoint& anEndLine2)
 	{
-		return Shape2DUtils::getIntersection(	aStartLine1,anEndLine1,aStartLine2,anEndLine2) != wxDefaultPosition;
+		// The end points of each line may not lie on the same side of the other line
+		if (getOrientation( aStartLine1, anEndLine1, aStartLine2) * getOrientation( aStartLine1, anEndLine1, anEndLine2) > 0)
+		{
+			return false;
+		}
+		if (getOrientation( aStartLine2, anEndLine2, aStartLine1) * getOrientation( aStartLine2, anEndLine2, anEndLine1) > 0)
+		{
+			return false;
+		}
+		// Lines that cross have overlapping boxes, for lines on one line (all orientations 0) the boxes decide
+		return std::min( aStartLine2.x, anEndLine2.x) <= std::max( aStartLine1.x, anEndLine1.x) &&
+				std::min( aStartLine1.x, anEndLine1.x) <= std::max( aStartLine2.x, anEndLine2.x) &&
+				std::min( aStartLine2.y, anEndLine2.y) <= std::max( aStartLine1.y, anEndLine1.y) &&
+				std::min( aStartLine1.y, anEndLine1.y) <= std::max( aStartLine2.y, anEndLine2.y);
 	}
 	/**
 	 *
@@ -62,110 +186,55 @@ namespace Utils
 														const wxPoint& aStartLine2,
 														const wxPoint& anEndLine2)
 	{
-		/*
-		// https://www.geeksforgeeks.org/program-for-point-of-intersection-of-two-lines/
-
-		// Line AB represented as a1x + b1y = c1
-		double a1 = anEndLine1.y- aStartLine1.y;
-		double b1 = aStartLine1.x- anEndLine1.x;
-		double c1 = a1*(aStartLine1.x) + b1*(aStartLine1.y);
-
-		// Line CD represented as a2x + b2y = c2
-		double a2 = anEndLine2.y- aStartLine2.y;
-		double b2 = aStartLine2.x- anEndLine2.x;
-		double c2 = a2*(aStartLine2.x) + b2*(aStartLine2.y);
-
-		double determinant = a1*b2 - a2*b1;
-
-		if (determinant == 0)
-		{
-			// The lines are parallel.
-			return wxDefaultPosition;
-		}
-		else
+		wxPoint intersection;
+		if (getIntersection( aStartLine1, anEndLine1, aStartLine2, anEndLine2, intersection))
 		{
-			double x = (b2*c1 - b1*c2)/determinant;
-			double y = (a1*c2 - a2*c1)/determinant;
-			return wxPoint( static_cast<int>(x), static_cast<int>(y));
+			return intersection;
 		}
-		*/
-
-
-		/*
-		 // https://rosettacode.org/wiki/Find_the_intersection_of_two_lines#C++
-
-		double x1 = aStartLine1.x;
-		double x2 = anEndLine1.x;
-		double x3 = aStartLine2.x;
-		double x4 = anEndLine2.x;
-		double y1 = aStartLine1.y;
-		double y2 = anEndLine1.y;
-		double y3 = aStartLine2.y;
-		double y4 = anEndLine2.y;
-
-
-		double detL1 = Det(x1, y1, x2, y2);
-		double detL2 = Det(x3, y3, x4, y4);
-		double x1mx2 = x1 - x2;
-		double x3mx4 = x3 - x4;
-		double y1my2 = y1 - y2;
-		double y3my4 = y3 - y4;
-
-		double denom = Det(x1mx2, y1my2, x3mx4, y3my4);
-		if(denom == 0.0) // Lines don't seem to cross
+		return wxDefaultPosition;
+	}
+	/**
+	 *
+	 */
+	/* static */bool Shape2DUtils::getIntersection(	const wxPoint& aStartLine1,
+													const wxPoint& anEndLine1,
+													const wxPoint& aStartLine2,
+													const wxPoint& anEndLine2,
+													wxPoint& anIntersection)
+	{
+		if (!intersect( aStartLine1, anEndLine1, aStartLine2, anEndLine2))
 		{
-			return wxDefaultPosition;
+			return false;
 		}
 
-		double xnom = Det(detL1, x1mx2, detL2, x3mx4);
-		double ynom = Det(detL1, y1my2, detL2, y3my4);
-		double ixOut = xnom / denom;
-		double iyOut = ynom / denom;
-		if(!isfinite(ixOut) || !isfinite(iyOut)) // Probably a numerical issue
+		std::int64_t dx1 = static_cast< std::int64_t >( anEndLine1.x) - aStartLine1.x;
+		std::int64_t dy1 = static_cast< std::int64_t >( anEndLine1.y) - aStartLine1.y;
+		std::int64_t dx2 = static_cast< std::int64_t >( anEndLine2.x) - aStartLine2.x;
+		std::int64_t dy2 = static_cast< std::int64_t >( anEndLine2.y) - aStartLine2.y;
+		std::int64_t d = dx1 * dy2 - dy1 * dx2;
+		if (d != 0)
 		{
-			return wxDefaultPosition;
+			// The lines cross at aStartLine1 + t * (dx1, dy1), only the point itself is rounded
+			std::int64_t numerator = (static_cast< std::int64_t >( aStartLine2.x) - aStartLine1.x) * dy2 -
+										(static_cast< std::int64_t >( aStartLine2.y) - aStartLine1.y) * dx2;
+			double t = static_cast< double >( numerator) / static_cast< double >( d);
+			anIntersection = wxPoint(	static_cast< int >( std::lround( aStartLine1.x + static_cast< double >( dx1) * t)),
+										static_cast< int >( std::lround( aStartLine1.y + static_cast< double >( dy1) * t)));
+			return true;
 		}
 
-		//return wxDefaultPosition;
-		return wxPoint( static_cast<int>(ixOut), static_cast<int>(iyOut)); //All OK
-		*/
-
-		// I don't know where this is from...
-
-		double x1 = aStartLine1.x;
-		double x2 = anEndLine1.x;
-		double x3 = aStartLine2.x;
-		double x4 = anEndLine2.x;
-		double y1 = aStartLine1.y;
-		double y2 = anEndLine1.y;
-		double y3 = aStartLine2.y;
-		double y4 = anEndLine2.y;
-
-		double d = (x1 - x2) * (y3 - y4) - (y1 - y2) * (x3 - x4);
-		// If d is zero, there is no intersection
-		if (std::fabs(d-0.0) <= std::numeric_limits<float>::epsilon())
+		// The lines overlap or one of them is a point
+		if (IsInBox( aStartLine2, aStartLine1, anEndLine1))
 		{
-			return wxDefaultPosition;
-		}
-
-		// Get the x and y
-		double pre = (x1 * y2 - y1 * x2);
-		double post = (x3 * y4 - y3 * x4);
-		double x = (pre * (x3 - x4) - (x1 - x2) * post) / d;
-		double y = (pre * (y3 - y4) - (y1 - y2) * post) / d;
-
-		// Check if the x and y coordinates are within both lines
-		if (x < std::min( x1, x2) || x > std::max( x1, x2) || x < std::min( x3, x4) || x > std::max( x3, x4))
+			anIntersection = aStartLine2;
+		} else if (IsInBox( anEndLine2, aStartLine1, anEndLine1))
 		{
-			return wxDefaultPosition;
-		}
-		if (y < std::min( y1, y2) || y > std::max( y1, y2) || y < std::min( y3, y4) || y > std::max( y3, y4))
+			anIntersection = anEndLine2;
+		} else
 		{
-			return wxDefaultPosition;
+			anIntersection = aStartLine1;
 		}
-
-		// Return the point of intersection
-		return wxPoint( static_cast<int>(x), static_cast<int>(y));
+		return true;
 	}
 	/**
 	 *
@@ -175,6 +244,49 @@ namespace Utils
 	{
 		return std::sqrt( (aPoint1.x - aPoint2.x) * (aPoint1.x - aPoint2.x) + (aPoint1.y - aPoint2.y) * (aPoint1.y - aPoint2.y));
 	}
+	/**
+	 *
+	 */
+	/* static */int Shape2DUtils::getOrientation(	const wxPoint& aPoint1,
+													const wxPoint& aPoint2,
+													const wxPoint& aPoint3)
+	{
+		std::int64_t crossProduct = CrossProduct( aPoint1, aPoint2, aPoint3);
+		return (crossProduct > 0) - (crossProduct < 0);
+	}
+	/**
+	 *
+	 */
+	/* static */bool Shape2DUtils::isNearSegment(	const wxPoint& aStartPoint,
+													const wxPoint& anEndPoint,
+													const wxPoint& aPoint,
+													int aRadius)
+	{
+		if (aRadius <= 0)
+		{
+			return false;
+		}
+		std::int64_t squaredRadius = static_cast< std::int64_t >( aRadius) * aRadius;
+
+		std::int64_t dx = static_cast< std::int64_t >( anEndPoint.x) - aStartPoint.x;
+		std::int64_t dy = static_cast< std::int64_t >( anEndPoint.y) - aStartPoint.y;
+		std::int64_t dot = (static_cast< std::int64_t >( aPoint.x) - aStartPoint.x) * dx + (static_cast< std::int64_t >( aPoint.y) - aStartPoint.y) * dy;
+		std::int64_t squaredLength = dx * dx + dy * dy;
+		// Beyond one of the ends the nearest point of the segment is that end
+		if (dot <= 0)
+		{
+			return getSquaredDistance( aPoint, aStartPoint) < squaredRadius;
+		}
+		if (dot >= squaredLength)
+		{
+			return getSquaredDistance( aPoint, anEndPoint) < squaredRadius;
+		}
+		// The squared distance to the line is crossProduct^2 / squaredLength, both sides are multiplied by squaredLength.
+		// The products need up to 126 bits.
+		std::int64_t crossProduct = CrossProduct( aStartPoint, anEndPoint, aPoint);
+		boost::multiprecision::uint128_t absoluteCrossProduct = static_cast< std::uint64_t >( crossProduct < 0 ? -crossProduct : crossProduct);
+		return absoluteCrossProduct * absoluteCrossProduct < boost::multiprecision::uint128_t( squaredRadius) * static_cast< std::uint64_t >( squaredLength);
+	}
 	/**
 	 *
 	 */
@@ -313,6 +425,48 @@ namespace Utils
 		}
 		return false;
 	}
+	/**
+	 *
+	 */
+	/* static */std::size_t Shape2DUtils::findIntersection(	const wxPoint& aStartLine,
+															const wxPoint& anEndLine,
+															const LineBlock& someLines,
+															std::size_t aFirstLine /* = 0 */)
+	{
+		std::size_t line = aFirstLine;
+#if defined(__AVX__) || defined(__SSE2__)
+		std::int64_t largestCoordinate = std::max( {	someLines.largestCoordinate,
+														std::abs( static_cast< std::int64_t >( aStartLine.x)),
+														std::abs( static_cast< std::int64_t >( aStartLine.y)),
+														std::abs( static_cast< std::int64_t >( anEndLine.x)),
+														std::abs( static_cast< std::int64_t >( anEndLine.y)) });
+		if (largestCoordinate < exactLanesCoordinate)
+		{
+			for (; line + Lanes::count <= someLines.size(); line += Lanes::count)
+			{
+				int mask = IntersectionMask( aStartLine, anEndLine, someLines, line);
+				if (mask != 0)
+				{
+					std::size_t lane = 0;
+					while ((mask & 1) == 0)
+					{
+						++lane;
+						mask >>= 1;
+					}
+					return line + lane;
+				}
+			}
+		}
+#endif
+		for (; line < someLines.size(); ++line)
+		{
+			if (intersect( aStartLine, anEndLine, wxPoint( someLines.startX[line], someLines.startY[line]), wxPoint( someLines.endX[line], someLines.endY[line])))
+			{
+				return line;
+			}
+		}
+		return LineBlock::npos;
+	}
 	/**
 	 *
 	 */
@@ -8,10 +8,73 @@
 #include "Point.hpp"
 #include "Size.hpp"
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
 #include <string>
+#include <utility>
+#include <vector>
 
 namespace Utils
 {
+	/**
+	 * Lines as a structure of arrays: all x coordinates of the start points together and so on. This is the layout
+	 * the batch functions of Shape2DUtils work on, they test a number of lines with one instruction.
+	 */
+	struct LineBlock
+	{
+			/**
+			 * Returned by the batch functions if no line is found
+			 */
+			static constexpr std::size_t npos = std::numeric_limits< std::size_t >::max();
+			/**
+			 *
+			 */
+			void push_back(	const wxPoint& aStartPoint,
+							const wxPoint& anEndPoint)
+			{
+				startX.push_back( aStartPoint.x);
+				startY.push_back( aStartPoint.y);
+				endX.push_back( anEndPoint.x);
+				endY.push_back( anEndPoint.y);
+				largestCoordinate = std::max( { largestCoordinate,
+												std::abs( static_cast< std::int64_t >( aStartPoint.x)),
+												std::abs( static_cast< std::int64_t >( aStartPoint.y)),
+												std::abs( static_cast< std::int64_t >( anEndPoint.x)),
+												std::abs( static_cast< std::int64_t >( anEndPoint.y)) });
+			}
+			/**
+			 *
+			 */
+			void clear()
+			{
+				startX.clear();
+				startY.clear();
+				endX.clear();
+				endY.clear();
+				largestCoordinate = 0;
+			}
+			/**
+			 *
+			 */
+			std::size_t size() const
+			{
+				return startX.size();
+			}
+
+			std::vector< int > startX;
+			std::vector< int > startY;
+			std::vector< int > endX;
+			std::vector< int > endY;
+			/**
+			 * The largest absolute value of the coordinates, the batch functions use it to check whether
+			 * the vector code is exact for the block
+			 */
+			std::int64_t largestCoordinate = 0;
+	};
+	// struct LineBlock
 	/**
 	 *
 	 */
@@ -38,7 +101,8 @@ namespace Utils
 			 * @param aEndLine1
 			 * @param aStartLine2
 			 * @param anEndLine2
-			 * @return true if the lines intersect, false otherwise
+			 * @return true if the lines intersect, false otherwise. Lines that touch or overlap intersect. This is
+			 * 			exact, see getOrientation.
 			 */
 			static bool intersect(	const wxPoint& aStartLine1,
 									const wxPoint& anEndLine1,
@@ -50,12 +114,25 @@ namespace Utils
 			 * @param aEndLine1
 			 * @param aStartLine2
 			 * @param anEndLine2
-			 * @return a valid wxPoint it the ;lines intersect, wxDefaultPosition otherwise
+			 * @return a valid wxPoint it the lines intersect, wxDefaultPosition otherwise. Lines that intersect
+			 * 			at wxDefaultPosition cannot be told apart from lines that do not, use the other getIntersection
+			 * 			or intersect for those.
 			 */
 			static wxPoint getIntersection(	const wxPoint& aStartLine1,
 											const wxPoint& anEndLine1,
 											const wxPoint& aStartLine2,
 											const wxPoint& anEndLine2);
+			/**
+			 * Whether the lines intersect is decided by intersect. The intersection is rounded to the nearest
+			 * point, for lines that overlap it is the first end point of one line that lies on the other.
+			 *
+			 * @return true if the lines intersect, anIntersection is only filled in then
+			 */
+			static bool getIntersection(	const wxPoint& aStartLine1,
+											const wxPoint& anEndLine1,
+											const wxPoint& aStartLine2,
+											const wxPoint& anEndLine2,
+											wxPoint& anIntersection);
 			/**
 			 *
 			 * @param aPoint1
@@ -64,6 +141,43 @@ namespace Utils
 			 */
 			static double distance(const wxPoint& aPoint1,
 								   const wxPoint& aPoint2);
+			/**
+			 * @name Exact predicates
+			 *
+			 * These work on the integer coordinates with 64 bit integer arithmetic (boost::multiprecision::uint128_t for
+			 * the last products of isNearSegment), without division or square root, so their results are exact and the
+			 * same on every machine. They are exact for coordinates from -2^30 up to 2^30.
+			 */
+			//@{
+			/**
+			 * @return 1 if aPoint3 lies to the left of the line from aPoint1 to aPoint2 (counterclockwise with
+			 * 			the y axis pointing up, clockwise on the screen), -1 if it lies to the right and 0 if the
+			 * 			three points are on one line
+			 */
+			static int getOrientation(	const wxPoint& aPoint1,
+										const wxPoint& aPoint2,
+										const wxPoint& aPoint3);
+			/**
+			 * @return the square of the distance between the points, inline because the OccupancyGrid calls it per cell
+			 */
+			static std::int64_t getSquaredDistance(	const wxPoint& aPoint1,
+														const wxPoint& aPoint2)
+			{
+				std::int64_t dx = static_cast< std::int64_t >( aPoint1.x) - aPoint2.x;
+				std::int64_t dy = static_cast< std::int64_t >( aPoint1.y) - aPoint2.y;
+				return dx * dx + dy * dy;
+			}
+			/**
+			 * The squared distance from aPoint to the segment (not the whole line) is compared with the
+			 * squared radius, a segment of length 0 is a point
+			 *
+			 * @return true if aPoint is less than aRadius away from the segment from aStartPoint to anEndPoint
+			 */
+			static bool isNearSegment(	const wxPoint& aStartPoint,
+										const wxPoint& anEndPoint,
+										const wxPoint& aPoint,
+										int aRadius);
+			//@}
 			/**
 			 *
 			 * @param aPolygon The array of points
@@ -101,6 +215,24 @@ namespace Utils
 									const wxPoint& aPoint,
 									int aRadius = 6,
 									bool aClosedShape = true);
+			/**
+			 * @name Batch functions
+			 *
+			 * These test one line against all lines of a LineBlock, with SSE2 or AVX if the compiler targets it and one
+			 * line at a time otherwise. The results are exactly those of the functions for a single line: the vector code
+			 * of findIntersection computes the orientations of intersect in doubles, which is exact for coordinates from
+			 * -2^25 up to 2^25. Blocks with larger coordinates are tested one line at a time. The line of the query is
+			 * the first line of intersect, a line of the block the second one.
+			 */
+			//@{
+			/**
+			 * @return the index of the first line from aFirstLine on for which intersect( aStartLine, anEndLine, ...) is true, LineBlock::npos if none
+			 */
+			static std::size_t findIntersection(	const wxPoint& aStartLine,
+													const wxPoint& anEndLine,
+													const LineBlock& someLines,
+													std::size_t aFirstLine = 0);
+			//@}
 
 			/**
 			 * The rotation will be done around (0.0)
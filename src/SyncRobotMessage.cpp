@@ -19,12 +19,27 @@ namespace Messaging {
         std::istringstream is(message);
 
         is >> position.x >> position.y >> front.x >> front.y;
+
+        // An older message ends here
+        std::size_t count = 0;
+        if (is >> count) {
+            trajectory.resize(count);
+            for (wxPoint &point : trajectory) {
+                is >> point.x >> point.y;
+            }
+        }
     }
 
     void SyncRobotMessage::fillMessage(Messaging::Message &msg) const {
         std::stringstream ss;
 
         ss <<  position.x << " " << position.y << " " << front.x << " " << front.y;
+        if (!trajectory.empty()) {
+            ss << " " << trajectory.size();
+            for (const wxPoint &point : trajectory) {
+                ss << " " << point.x << " " << point.y;
+            }
+        }
 
         msg.setMessageType(MessageType::SynchronizeRobot);
         msg.setBody(ss.str());
@@ -38,10 +53,21 @@ namespace Messaging {
         return front;
     }
 
+    const std::vector<wxPoint>& SyncRobotMessage::getTrajectory() const {
+        return trajectory;
+    }
+
+    void SyncRobotMessage::setTrajectory(const std::vector<wxPoint>& aTrajectory) {
+        trajectory = aTrajectory;
+    }
+
     void SyncRobotMessage::updateRobot(Model::Robot& robot) const {
         robot.setFront(getFront());
         robot.setPosition(getPosition());
         robot.updateWalls();
+        if (!trajectory.empty()) {
+            robot.reserve(trajectory);
+        }
     };
 
     Model::RobotPtr SyncRobotMessage::newRobot() const {
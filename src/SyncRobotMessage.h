@@ -8,6 +8,8 @@
 #include "Robot.hpp"
 #include "BoundedVector.hpp"
 
+#include <vector>
+
 namespace Messaging {
     class SyncRobotMessage {
     public:
@@ -24,6 +26,10 @@ namespace Messaging {
         wxPoint getPosition() const;
         Model::BoundedVector getFront() const;
 
+        // The positions of the robot for the coming steps, empty if they did not change
+        const std::vector<wxPoint>& getTrajectory() const;
+        void setTrajectory(const std::vector<wxPoint>& aTrajectory);
+
         void updateRobot(Model::Robot& robot) const;
         Model::RobotPtr newRobot() const;
 
@@ -33,6 +39,7 @@ namespace Messaging {
     private:
         wxPoint position;
         Model::BoundedVector front;
+        std::vector<wxPoint> trajectory;
     };
 }
 
@@ -0,0 +1,222 @@
+#include "VisibilityGraph.hpp"
+
+#include "Shape2DUtils.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace PathAlgorithm
+{
+	/**
+	 * The corners of the rectangle around the line from aPoint1 to aPoint2 at aDistance from the line, in polygon order
+	 */
+	std::array< wxPoint, 4 > GetInflatedCorners(	const wxPoint& aPoint1,
+													const wxPoint& aPoint2,
+													double aDistance)
+	{
+		double dx = aPoint2.x - aPoint1.x;
+		double dy = aPoint2.y - aPoint1.y;
+		double length = std::sqrt( dx * dx + dy * dy);
+		if (length == 0.0)
+		{
+			dx = 1.0;
+			dy = 0.0;
+		} else
+		{
+			dx /= length;
+			dy /= length;
+		}
+
+		// Along the line and perpendicular to it
+		double ax = dx * aDistance;
+		double ay = dy * aDistance;
+		double nx = -dy * aDistance;
+		double ny = dx * aDistance;
+
+		return {{	wxPoint( static_cast< int >( std::lround( aPoint1.x - ax + nx)), static_cast< int >( std::lround( aPoint1.y - ay + ny))),
+					wxPoint( static_cast< int >( std::lround( aPoint2.x + ax + nx)), static_cast< int >( std::lround( aPoint2.y + ay + ny))),
+					wxPoint( static_cast< int >( std::lround( aPoint2.x + ax - nx)), static_cast< int >( std::lround( aPoint2.y + ay - ny))),
+					wxPoint( static_cast< int >( std::lround( aPoint1.x - ax - nx)), static_cast< int >( std::lround( aPoint1.y - ay - ny)))}};
+	}
+	/**
+	 *
+	 */
+	VisibilityGraph::VisibilityGraph() :
+								freeRadius( 0),
+								wallsVersion( 0),
+								built( false),
+								startSeesGoal( false)
+	{
+		// The graph is tiny and not bounded by the grid
+		setStorageMode( NodeStorage);
+	}
+	/**
+	 *
+	 */
+	void VisibilityGraph::prepareSearch(	const Vertex& aStart,
+											const Vertex& aGoal,
+											int aFreeRadius)
+	{
+		WallSnapshotPtr wallSnapshot = getWallSnapshot();
+		if (!built || freeRadius != aFreeRadius || wallsVersion != wallSnapshot->getWallsVersion())
+		{
+			build( *wallSnapshot, aFreeRadius);
+		}
+
+		start = aStart.asPoint();
+		goal = aGoal.asPoint();
+
+		std::vector< std::size_t > startObstacles = getObstaclesAt( start);
+		std::vector< std::size_t > goalObstacles = getObstaclesAt( goal);
+
+		std::vector< std::size_t > startGoalObstacles( startObstacles);
+		startGoalObstacles.insert( startGoalObstacles.end(), goalObstacles.begin(), goalObstacles.end());
+		startSeesGoal = isVisible( start, goal, startGoalObstacles);
+
+		startVisibleNodes.clear();
+		nodeSeesGoal.assign( nodes.size(), false);
+		for (std::size_t i = 0; i < nodes.size(); ++i)
+		{
+			if (isVisible( start, nodes[i], startObstacles))
+			{
+				startVisibleNodes.push_back( i);
+			}
+			nodeSeesGoal[i] = isVisible( nodes[i], goal, goalObstacles);
+		}
+	}
+	/**
+	 *
+	 */
+	void VisibilityGraph::getConnections(	const Vertex& aVertex,
+											const Vertex& aGoal,
+											std::vector< Edge >& aConnections)
+	{
+		aConnections.clear();
+
+		if (aVertex.asPoint() == start)
+		{
+			for (std::size_t i : startVisibleNodes)
+			{
+				aConnections.push_back( Edge( aVertex, Vertex( nodes[i])));
+			}
+			if (startSeesGoal)
+			{
+				aConnections.push_back( Edge( aVertex, Vertex( aGoal.x, aGoal.y)));
+			}
+			return;
+		}
+
+		std::map< Vertex, std::size_t, VertexLessIdCompare >::const_iterator node = nodeIndices.find( aVertex);
+		if (node != nodeIndices.end())
+		{
+			std::size_t index = (*node).second;
+			for (std::size_t i : visibleNodes[index])
+			{
+				aConnections.push_back( Edge( aVertex, Vertex( nodes[i])));
+			}
+			if (nodeSeesGoal[index])
+			{
+				aConnections.push_back( Edge( aVertex, Vertex( aGoal.x, aGoal.y)));
+			}
+		}
+	}
+	/**
+	 *
+	 */
+	void VisibilityGraph::build(	const WallSnapshot& aWallSnapshot,
+									int aFreeRadius)
+	{
+		obstacles.clear();
+		obstacleSides.clear();
+		nodes.clear();
+		nodeIndices.clear();
+		visibleNodes.clear();
+
+		for (const WallSegment& wall : aWallSnapshot.getWalls())
+		{
+			Obstacle obstacle;
+			obstacle.point1 = wall.first;
+			obstacle.point2 = wall.second;
+			obstacle.corners = GetInflatedCorners( obstacle.point1, obstacle.point2, aFreeRadius);
+			obstacles.push_back( obstacle);
+			for (std::size_t side = 0; side < 4; ++side)
+			{
+				obstacleSides.push_back( obstacle.corners[side], obstacle.corners[(side + 1) % 4]);
+			}
+		}
+
+		// The nodes are 2 pixels further out than the corners of the obstacles so the rounding
+		// of the corners never puts a node on (or in) its own obstacle
+		for (const Obstacle& obstacle : obstacles)
+		{
+			for (const wxPoint& corner : GetInflatedCorners( obstacle.point1, obstacle.point2, aFreeRadius + 2))
+			{
+				if (nodeIndices.find( Vertex( corner)) == nodeIndices.end() && getObstaclesAt( corner).empty())
+				{
+					nodeIndices.insert( std::make_pair( Vertex( corner), nodes.size()));
+					nodes.push_back( corner);
+				}
+			}
+		}
+
+		const std::vector< std::size_t > noObstacles;
+		visibleNodes.resize( nodes.size());
+		for (std::size_t i = 0; i < nodes.size(); ++i)
+		{
+			for (std::size_t j = i + 1; j < nodes.size(); ++j)
+			{
+				if (isVisible( nodes[i], nodes[j], noObstacles))
+				{
+					visibleNodes[i].push_back( j);
+					visibleNodes[j].push_back( i);
+				}
+			}
+		}
+
+		freeRadius = aFreeRadius;
+		wallsVersion = aWallSnapshot.getWallsVersion();
+		built = true;
+	}
+	/**
+	 *
+	 */
+	std::vector< std::size_t > VisibilityGraph::getObstaclesAt( const wxPoint& aPoint) const
+	{
+		std::vector< std::size_t > result;
+		for (std::size_t i = 0; i < obstacles.size(); ++i)
+		{
+			if (Utils::Shape2DUtils::isInsidePolygon( obstacles[i].corners.data(), 4, aPoint))
+			{
+				result.push_back( i);
+			}
+		}
+		return result;
+	}
+	/**
+	 *
+	 */
+	bool VisibilityGraph::isVisible(	const wxPoint& aPoint1,
+										const wxPoint& aPoint2,
+										const std::vector< std::size_t >& anIgnoredObstacles) const
+	{
+		for (std::size_t i : anIgnoredObstacles)
+		{
+			if (Utils::Shape2DUtils::intersect( aPoint1, aPoint2, obstacles[i].point1, obstacles[i].point2))
+			{
+				return false;
+			}
+		}
+		// The sides of all obstacles are tested in batches, a side of an ignored obstacle does not count
+		std::size_t side = 0;
+		while ((side = Utils::Shape2DUtils::findIntersection( aPoint1, aPoint2, obstacleSides, side)) != Utils::LineBlock::npos)
+		{
+			std::size_t obstacle = side / 4;
+			if (std::find( anIgnoredObstacles.begin(), anIgnoredObstacles.end(), obstacle) == anIgnoredObstacles.end())
+			{
+				return false;
+			}
+			side = (obstacle + 1) * 4;
+		}
+		return true;
+	}
+} // namespace PathAlgorithm
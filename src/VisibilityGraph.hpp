@@ -0,0 +1,120 @@
+#ifndef VISIBILITYGRAPH_HPP_
+#define VISIBILITYGRAPH_HPP_
+
+#include "Config.hpp"
+
+#include "AStar.hpp"
+#include "Shape2DUtils.hpp"
+
+#include <array>
+#include <map>
+#include <vector>
+
+namespace PathAlgorithm
+{
+	/**
+	 * An any-angle planner that searches a visibility graph instead of the pixel grid.
+	 *
+	 * Every wall is inflated by the radius of the robot to a rectangle (an obstacle). The vertices of the graph
+	 * are the corners of the obstacles, moved a little further out, and two vertices are connected if the line
+	 * between them does not intersect (Shape2DUtils::intersect) any side of an obstacle. The graph of the walls
+	 * is only built again if the walls or the radius change, the start and the goal are connected for every search.
+	 *
+	 * The graph grows with the number of walls, not with the area of the world. The resulting Path only contains
+	 * the start, the corners to go around and the goal, Robot::step interpolates between them.
+	 */
+	class VisibilityGraph : public AStar
+	{
+		public:
+			/**
+			 *
+			 */
+			VisibilityGraph();
+
+		protected:
+			/**
+			 * (Re)builds the graph of the walls if needed and connects the start and the goal
+			 */
+			virtual void prepareSearch(	const Vertex& aStart,
+										const Vertex& aGoal,
+										int aFreeRadius) override;
+			/**
+			 * The vertices that are visible from aVertex
+			 */
+			virtual void getConnections(	const Vertex& aVertex,
+											const Vertex& aGoal,
+											std::vector< Edge >& aConnections) override;
+
+		private:
+			/**
+			 * A wall inflated by the free radius
+			 */
+			struct Obstacle
+			{
+					wxPoint point1;
+					wxPoint point2;
+					std::array< wxPoint, 4 > corners;
+			};
+			/**
+			 *
+			 */
+			void build(	const WallSnapshot& aWallSnapshot,
+						int aFreeRadius);
+			/**
+			 *
+			 * @return the indices of the obstacles that contain aPoint
+			 */
+			std::vector< std::size_t > getObstaclesAt( const wxPoint& aPoint) const;
+			/**
+			 * A robot can go in a straight line from aPoint1 to aPoint2 if the line does not intersect any obstacle.
+			 * For an obstacle that contains one of the points (anIgnoredObstacles) only the wall itself is checked so a
+			 * robot that is too close to a wall can still move away from it.
+			 */
+			bool isVisible(	const wxPoint& aPoint1,
+							const wxPoint& aPoint2,
+							const std::vector< std::size_t >& anIgnoredObstacles) const;
+			/**
+			 *
+			 */
+			std::vector< Obstacle > obstacles;
+			/**
+			 * The sides of the obstacles, side s of obstacle i is line 4 * i + s
+			 */
+			Utils::LineBlock obstacleSides;
+			/**
+			 * The corners of the obstacles that are not inside another obstacle
+			 */
+			std::vector< wxPoint > nodes;
+			/**
+			 *
+			 */
+			std::map< Vertex, std::size_t, VertexLessIdCompare > nodeIndices;
+			/**
+			 * For every node the indices of the nodes that are visible from it
+			 */
+			std::vector< std::vector< std::size_t > > visibleNodes;
+			/**
+			 *
+			 */
+			int freeRadius;
+			/**
+			 *
+			 */
+			unsigned long wallsVersion;
+			/**
+			 *
+			 */
+			bool built;
+			/**
+			 * @name The connections of the start and the goal of the current search
+			 */
+			//@{
+			wxPoint start;
+			wxPoint goal;
+			std::vector< std::size_t > startVisibleNodes;
+			std::vector< bool > nodeSeesGoal;
+			bool startSeesGoal;
+			//@}
+	}; // class VisibilityGraph
+} // namespace PathAlgorithm
+#endif // VISIBILITYGRAPH_HPP_
@@ -1,6 +1,7 @@
 #include "Wall.hpp"
 
 #include "Logger.hpp"
+#include "RobotWorld.hpp"
 #include "Shape2DUtils.hpp"
 
 #include <sstream>
@@ -34,7 +35,10 @@ namespace Model {
      */
     void Wall::setPoint1(const wxPoint &aPoint1,
                          bool aNotifyObservers /*= true*/) {
-        point1 = aPoint1;
+        if (point1 != aPoint1) {
+            point1 = aPoint1;
+            RobotWorld::getRobotWorld().wallMoved(*this);
+        }
         if (aNotifyObservers == true) {
             notifyObservers();
         }
@@ -53,7 +57,10 @@ namespace Model {
      */
     void Wall::setPoint2(const wxPoint &aPoint2,
                          bool aNotifyObservers /*= true*/) {
-        point2 = aPoint2;
+        if (point2 != aPoint2) {
+            point2 = aPoint2;
+            RobotWorld::getRobotWorld().wallMoved(*this);
+        }
         if (aNotifyObservers == true) {
             notifyObservers();
         }
@@ -0,0 +1,63 @@
+#include "WallSnapshot.hpp"
+
+#include "Wall.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace PathAlgorithm
+{
+	/**
+	 * Mixes the bits of aValue (the finaliser of splitmix64), so that the sum of the hashes of the walls is a hash as well
+	 */
+	static std::uint64_t MixBits( std::uint64_t aValue)
+	{
+		aValue = (aValue ^ (aValue >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		aValue = (aValue ^ (aValue >> 27)) * 0x94D049BB133111EBULL;
+		return aValue ^ (aValue >> 31);
+	}
+	/**
+	 * The same for both directions of aWall
+	 */
+	static std::uint64_t HashWall( const WallSegment& aWall)
+	{
+		wxPoint first = aWall.first;
+		wxPoint second = aWall.second;
+		if (std::make_pair( second.x, second.y) < std::make_pair( first.x, first.y))
+		{
+			std::swap( first, second);
+		}
+		std::uint64_t hash = MixBits( (static_cast< std::uint64_t >( static_cast< std::uint32_t >( first.x)) << 32) | static_cast< std::uint32_t >( first.y));
+		return MixBits( hash ^ ((static_cast< std::uint64_t >( static_cast< std::uint32_t >( second.x)) << 32) | static_cast< std::uint32_t >( second.y)));
+	}
+	/**
+	 *
+	 */
+	WallSnapshot::WallSnapshot(	const std::vector< Model::WallPtr >& aWalls,
+								unsigned long aWallsVersion) :
+									wallsVersion( aWallsVersion),
+									wallsHash( aWalls.size())
+	{
+		walls.reserve( aWalls.size());
+		for (Model::WallPtr wall : aWalls)
+		{
+			walls.push_back( WallSegment( wall->getPoint1(), wall->getPoint2()));
+			extent = extent.united( wall->getPoint1()).united( wall->getPoint2());
+			wallsHash += HashWall( walls.back());
+		}
+	}
+	/**
+	 *
+	 */
+	ClearanceMapPtr WallSnapshot::getClearanceMap( int aMinimumMargin /*= 64*/) const
+	{
+		std::lock_guard< std::mutex > guard( clearanceMapMutex);
+
+		if (!clearanceMap || clearanceMap->getMargin() < aMinimumMargin)
+		{
+			int margin = clearanceMap ? std::max( clearanceMap->getMargin(), aMinimumMargin) : aMinimumMargin;
+			clearanceMap = std::make_shared< const ClearanceMap >( walls, margin, wallsVersion);
+		}
+		return clearanceMap;
+	}
+} // namespace PathAlgorithm
@@ -0,0 +1,103 @@
+#ifndef WALLSNAPSHOT_HPP_
+#define WALLSNAPSHOT_HPP_
+
+#include "Config.hpp"
+
+#include "ClearanceMap.hpp"
+#include "GridExtent.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Model
+{
+	class Wall;
+	typedef std::shared_ptr< Wall > WallPtr;
+}
+
+namespace PathAlgorithm
+{
+	class WallSnapshot;
+	typedef std::shared_ptr< const WallSnapshot > WallSnapshotPtr;
+
+	/**
+	 * A copy of the walls of the RobotWorld at one version of the walls. The walls of the RobotWorld may only be read
+	 * on the thread that changes them (the GUI thread), a snapshot can be searched on any thread.
+	 *
+	 * The ClearanceMap of the snapshot is computed by the first planner that asks for it, so a snapshot
+	 * is cheap to take and the expensive distance transform runs on the thread of the search.
+	 */
+	class WallSnapshot
+	{
+		public:
+			/**
+			 *
+			 */
+			WallSnapshot(	const std::vector< Model::WallPtr >& aWalls,
+							unsigned long aWallsVersion);
+			/**
+			 *
+			 */
+			unsigned long getWallsVersion() const
+			{
+				return wallsVersion;
+			}
+			/**
+			 * @return a hash of the geometry of the walls that does not depend on their order or direction, the same
+			 * walls have the same hash in any version of the walls
+			 */
+			std::uint64_t getWallsHash() const
+			{
+				return wallsHash;
+			}
+			/**
+			 * The walls in the order of RobotWorld::getWalls
+			 */
+			const std::vector< WallSegment >& getWalls() const
+			{
+				return walls;
+			}
+			/**
+			 * @return the extent of the end points of all walls, empty if there are no walls
+			 */
+			const GridExtent& getExtent() const
+			{
+				return extent;
+			}
+			/**
+			 * The clearance map of the walls with a margin of at least aMinimumMargin. It is only computed
+			 * again if a larger margin is asked for.
+			 */
+			ClearanceMapPtr getClearanceMap( int aMinimumMargin = 64) const;
+
+		private:
+			/**
+			 *
+			 */
+			std::vector< WallSegment > walls;
+			/**
+			 *
+			 */
+			GridExtent extent;
+			/**
+			 *
+			 */
+			unsigned long wallsVersion;
+			/**
+			 *
+			 */
+			std::uint64_t wallsHash;
+			/**
+			 *
+			 */
+			mutable ClearanceMapPtr clearanceMap;
+			/**
+			 * Guards clearanceMap, the snapshot may be searched by several threads at once
+			 */
+			mutable std::mutex clearanceMapMutex;
+	};
+	// class WallSnapshot
+} // namespace PathAlgorithm
+#endif // WALLSNAPSHOT_HPP_